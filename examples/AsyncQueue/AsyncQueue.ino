@@ -0,0 +1,71 @@
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Async.h>
+
+//==============================================================================//
+
+// Queues register writes and reads without waiting for the bus. The loop below keeps
+// computing while tick() runs the transactions one at a time. On ESP32 or RP2040,
+// tick() can be called from a task on the other core instead. The behavioural model
+// of the MCP23017 replaces the bus, so no hardware is needed. With real hardware, use
+// a CSE_MCP23017_TwoWire transport, and queue to each expander by its address.
+
+#define   SIM_ADDRESS         0x20
+
+//==============================================================================//
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017_Async busQueue (&simulator);
+
+uint8_t pattern = 0x01;
+uint32_t computeCount = 0;
+
+//==============================================================================//
+
+void readDone (ioeAsyncHandle_t handle, uint8_t response, const uint8_t *data, void *context) {
+  (void) handle;
+  (void) context;
+
+  if (response != MCP23017_RESP_OK) {
+    Serial.println (F("Read failed"));
+    return;
+  }
+
+  Serial.print (F("OLATA = 0x"));
+  Serial.print (data [0], HEX);
+  Serial.print (F(", loop iterations = "));
+  Serial.println (computeCount);
+}
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  // Make all the pins outputs.
+  uint8_t direction [2] = {0x00, 0x00};
+  busQueue.write (SIM_ADDRESS, MCP23017_REG_IODIRA, direction, 2);
+}
+
+//==============================================================================//
+
+void loop() {
+  static uint32_t lastUpdate = 0;
+
+  if ((millis() - lastUpdate) >= 500) {
+    lastUpdate = millis();
+    pattern = (pattern << 1) | (pattern >> 7);
+
+    // Both calls return at once. The queue copies the data.
+    if (busQueue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &pattern, 1) == MCP23017_RESP_OK) {
+      busQueue.writeThenRead (SIM_ADDRESS, MCP23017_REG_OLATA, NULL, 1, readDone);
+    }
+  }
+
+  computeCount++; // The rest of the control loop
+  busQueue.tick();
+}
+
+//==============================================================================//
@@ -0,0 +1,144 @@
+
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Counter.h>
+
+//==============================================================================//
+
+// Measures the bus cost of the library calls against the behavioural model of the
+// MCP23017, so no hardware is needed. Each call is checked against a baseline. A call
+// that needs more transactions or bytes than its baseline is reported as FAIL.
+// The results are printed as CSV, one row per call. The host build runs the same table
+// with `runBusCost()` and fails when any call exceeds its baseline.
+
+#define   SIM_ADDRESS         0x20
+#define   HOST_INT_PIN        2     // Left unconnected, the model calls the handler directly
+#define   INPUT_PIN           3
+#define   OUTPUT_PIN          8
+
+//==============================================================================//
+
+typedef void (*benchFunction_t)(void);
+
+typedef struct {
+  const char *name;
+  benchFunction_t run;
+  uint32_t maxTransactions; // Baseline
+  uint32_t maxBytes;  // Baseline
+} benchCase_t;
+
+//==============================================================================//
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017_Counter counter (&simulator);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &counter);
+
+//==============================================================================//
+
+void isr (int8_t pin) {
+  (void) pin;
+}
+
+void benchBegin() { ioExpander.begin(); }
+void benchPinMode() { ioExpander.pinMode (OUTPUT_PIN, OUTPUT); }
+void benchDigitalWrite() { ioExpander.digitalWrite (OUTPUT_PIN, HIGH); }
+void benchTogglePin() { ioExpander.togglePin (OUTPUT_PIN); }
+void benchDigitalRead() { ioExpander.digitalRead (INPUT_PIN); }
+void benchPortWrite() { ioExpander.portWrite (MCP23017_PORT_B, HIGH); }
+void benchPortRead() { ioExpander.portRead (MCP23017_PORT_A); }
+void benchWriteWord() { ioExpander.writeWord (0xA500); }
+void benchReadWord() { ioExpander.readWord(); }
+void benchSetBits() { ioExpander.setBits (0x0F00); }
+void benchReadAll() { ioExpander.readAll(); }
+void benchAttachInterrupt() { ioExpander.attachInterrupt (INPUT_PIN, isr, MCP23017_INT_CHANGE); }
+void benchIsrSupervisor() { simulator.setInput (INPUT_PIN, LOW); ioExpander.isrSupervisor(); }
+void benchDispatchIdle() { ioExpander.dispatchInterrupt(); }
+
+void benchBatch() {
+  ioExpander.beginBatch();
+
+  for (uint8_t pin = 8; pin < 16; pin++) {
+    ioExpander.digitalWrite (pin, (pin & 0x1U) ? HIGH : LOW);
+  }
+
+  ioExpander.commit();
+}
+
+// Baselines as measured with the read-through cache policy.
+const benchCase_t benchCases [] = {
+  {"begin", benchBegin, 3, 4},
+  {"pinMode", benchPinMode, 3, 6},
+  {"digitalWrite", benchDigitalWrite, 2, 4},
+  {"togglePin", benchTogglePin, 2, 4},
+  {"digitalRead", benchDigitalRead, 1, 2},
+  {"portWrite", benchPortWrite, 1, 2},
+  {"portRead", benchPortRead, 1, 2},
+  {"writeWord", benchWriteWord, 1, 3},
+  {"readWord", benchReadWord, 1, 3},
+  {"setBits", benchSetBits, 2, 4},
+  {"readAll", benchReadAll, 1, 23},
+  {"attachInterrupt", benchAttachInterrupt, 7, 14},
+  {"isrSupervisor", benchIsrSupervisor, 1, 5},
+  {"dispatchInterrupt (idle)", benchDispatchIdle, 0, 0},
+  {"batch 8 x digitalWrite", benchBatch, 3, 20},
+};
+
+//==============================================================================//
+
+/**
+ * @brief Runs every case of the table and prints one CSV row per case.
+ * 
+ * @return true All calls are within their baselines.
+ * @return false At least one call exceeded its baseline.
+ */
+bool runBusCost() {
+  ioExpander.begin();
+  ioExpander.pinMode (INPUT_PIN, INPUT_PULLUP);
+  ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR);
+
+  bool passed = true;
+
+  Serial.println (F("api,transactions,starts,stops,bytes,us_100k,us_400k,us_1700k,max_transactions,max_bytes,result"));
+
+  for (size_t i = 0; i < (sizeof (benchCases) / sizeof (benchCases [0])); i++) {
+    counter.reset();
+    benchCases [i].run();
+    ioeBusCount_t count = counter.counts();
+
+    bool casePassed = (count.transactions <= benchCases [i].maxTransactions) && (count.bytes <= benchCases [i].maxBytes);
+    passed = passed && casePassed;
+
+    Serial.print (benchCases [i].name); Serial.print (',');
+    Serial.print (count.transactions); Serial.print (',');
+    Serial.print (count.starts); Serial.print (',');
+    Serial.print (count.stops); Serial.print (',');
+    Serial.print (count.bytes); Serial.print (',');
+    Serial.print (counter.busTime (100000UL)); Serial.print (',');
+    Serial.print (counter.busTime (400000UL)); Serial.print (',');
+    Serial.print (counter.busTime (1700000UL)); Serial.print (',');
+    Serial.print (benchCases [i].maxTransactions); Serial.print (',');
+    Serial.print (benchCases [i].maxBytes); Serial.print (',');
+    Serial.println (casePassed ? F("PASS") : F("FAIL"));
+  }
+
+  Serial.print (F("RESULT,"));
+  Serial.println (passed ? F("PASS") : F("FAIL"));
+
+  return passed;
+}
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+  runBusCost();
+}
+
+//==============================================================================//
+
+void loop() {
+}
+
+//==============================================================================//
@@ -0,0 +1,71 @@
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Debouncer.h>
+
+//==============================================================================//
+
+// Debounces all 16 inputs of an IO expander by polling. Every millisecond both
+// ports are read in one transaction and the sample is fed to the debouncer. A pin
+// must read the same for DEBOUNCE_SAMPLES polls in a row before a change is
+// accepted. The behavioural model of the MCP23017 replaces the bus, and a bouncing
+// button is emulated on BUTTON_PIN.
+
+#define   SIM_ADDRESS         0x20
+#define   BUTTON_PIN          3
+#define   DEBOUNCE_SAMPLES    5
+
+//==============================================================================//
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &simulator);
+CSE_MCP23017_Debouncer debouncer (DEBOUNCE_SAMPLES, 0xFFFF);  // Pulled-up inputs idle high
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  ioExpander.begin();
+
+  for (uint8_t pin = 0; pin < 16; pin++) {
+    ioExpander.pinMode (pin, INPUT_PULLUP);
+  }
+}
+
+//==============================================================================//
+
+void loop() {
+  static uint32_t lastPoll = 0;
+  static uint16_t tick = 0;
+
+  if ((millis() - lastPoll) < 1) {
+    return;
+  }
+
+  lastPoll = millis();
+  tick++;
+
+  // Press the button at tick 100 and release it at tick 400, with 10 ms of bounce.
+  uint16_t phase = tick % 500;
+
+  if ((phase >= 100) && (phase < 400)) {
+    simulator.setInput (BUTTON_PIN, (phase < 110) ? (phase & 0x1U) : LOW);
+  }
+  else {
+    simulator.setInput (BUTTON_PIN, (phase >= 400) && (phase < 410) ? (phase & 0x1U) : HIGH);
+  }
+
+  if (debouncer.update (ioExpander.readWord()) != 0) {
+    if (debouncer.fell() & (1U << BUTTON_PIN)) {
+      Serial.println (F("Pressed"));
+    }
+
+    if (debouncer.rose() & (1U << BUTTON_PIN)) {
+      Serial.println (F("Released"));
+    }
+  }
+}
+
+//==============================================================================//
@@ -0,0 +1,62 @@
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Encoder.h>
+
+//==============================================================================//
+
+// Reads two rotary encoders on the IO expander. The common pins of the encoders go
+// to ground, and the pull-ups of the IOE are used. The INTA and INTB outputs of the
+// IOE are mirrored and connected to HOST_INT_PIN. Each interrupt costs a single bus
+// transaction, and all the encoders are updated from it.
+
+#define   MCP23017_ADDRESS    0x20
+#define   HOST_INT_PIN        2
+
+//==============================================================================//
+
+CSE_MCP23017 ioExpander (0xFF, MCP23017_ADDRESS);
+CSE_MCP23017_Encoder encoders (&ioExpander);
+
+int8_t volumeKnob;
+int8_t tuningKnob;
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  Wire.begin();
+  ioExpander.begin();
+  ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR);
+
+  volumeKnob = encoders.attach (MCP23017_GPA0, MCP23017_GPA1);
+  tuningKnob = encoders.attach (MCP23017_GPB0, MCP23017_GPB1);
+  encoders.begin (true);
+}
+
+//==============================================================================//
+
+void loop() {
+  static int32_t lastVolume = 0;
+  static int32_t lastTuning = 0;
+
+  ioExpander.dispatchInterrupt();
+
+  int32_t volume = encoders.read (volumeKnob) / 4;  // One count per detent
+  int32_t tuning = encoders.read (tuningKnob) / 4;
+
+  if ((volume != lastVolume) || (tuning != lastTuning)) {
+    lastVolume = volume;
+    lastTuning = tuning;
+
+    Serial.print (F("Volume: "));
+    Serial.print (volume);
+    Serial.print (F(", Tuning: "));
+    Serial.print (tuning);
+    Serial.print (F(", Tuning speed: "));
+    Serial.println (encoders.velocity (tuningKnob));
+  }
+}
+
+//==============================================================================//
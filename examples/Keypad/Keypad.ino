@@ -0,0 +1,65 @@
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Keypad.h>
+
+//==============================================================================//
+
+// Scans an 8 x 8 key matrix. The rows are wired to GPA0-GPA7 and the columns to
+// GPB0-GPB7. The column pull-ups of the IOE are used, so no resistors are needed.
+// While no key is down, each update only reads the columns once.
+
+#define   MCP23017_ADDRESS    0x20
+#define   SCAN_INTERVAL_MS    10    // Also the debounce time
+
+//==============================================================================//
+
+CSE_MCP23017 ioExpander (0xFF, MCP23017_ADDRESS);
+CSE_MCP23017_Keypad keypad (&ioExpander);
+
+//==============================================================================//
+
+void printKeys (const __FlashStringHelper *label, uint64_t keys) {
+  while (keys != 0) {
+    uint8_t key = uint8_t (__builtin_ctzll (keys));
+    keys &= (keys - 1);
+
+    Serial.print (label);
+    Serial.print (F(" row "));
+    Serial.print (key / 8);
+    Serial.print (F(", column "));
+    Serial.println (key % 8);
+  }
+}
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  Wire.begin();
+  ioExpander.begin();
+  keypad.begin();
+}
+
+//==============================================================================//
+
+void loop() {
+  static uint32_t lastScan = 0;
+
+  if ((millis() - lastScan) < SCAN_INTERVAL_MS) {
+    return;
+  }
+
+  lastScan = millis();
+
+  if (keypad.update()) {
+    printKeys (F("Pressed"), keypad.pressedKeys());
+    printKeys (F("Released"), keypad.releasedKeys());
+  }
+  else if (keypad.ghosted()) {
+    Serial.println (F("Ambiguous keys, ignored"));
+  }
+}
+
+//==============================================================================//
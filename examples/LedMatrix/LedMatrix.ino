@@ -0,0 +1,63 @@
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_LedMatrix.h>
+
+//==============================================================================//
+
+// Refreshes an 8 x 8 LED matrix. The row (cathode) lines are wired to GPA0-GPA7 and
+// the column (anode) lines to GPB0-GPB7 through current limiting resistors. A bar
+// sweeps across the matrix, and the rows fade from dim to bright.
+
+#define   MCP23017_ADDRESS    0x20
+#define   REFRESH_RATE_HZ     60
+#define   TICK_INTERVAL_US    (1000000UL / (REFRESH_RATE_HZ * MCP23017_LED_ROWS * MCP23017_LED_LEVELS))
+
+//==============================================================================//
+
+CSE_MCP23017 ioExpander (0xFF, MCP23017_ADDRESS);
+CSE_MCP23017_LedMatrix matrix (&ioExpander);
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  Wire.begin();
+  Wire.setClock (400000);  // Each tick must fit in the tick interval
+  ioExpander.begin();
+  matrix.begin (LOW, HIGH);
+
+  for (uint8_t row = 0; row < MCP23017_LED_ROWS; row++) {
+    matrix.setBrightness (row, row + 1);
+  }
+}
+
+//==============================================================================//
+
+void loop() {
+  static uint32_t lastTick = 0;
+  static uint32_t lastFrame = 0;
+  static uint8_t column = 0;
+
+  if ((micros() - lastTick) >= TICK_INTERVAL_US) {
+    lastTick += TICK_INTERVAL_US;
+    matrix.tick();
+  }
+
+  // Draw the next frame in the back buffer while the current one is shown.
+  if (((millis() - lastFrame) >= 100) && matrix.ready()) {
+    lastFrame = millis();
+    column = (column + 1) % MCP23017_LED_COLUMNS;
+
+    matrix.clear();
+
+    for (uint8_t row = 0; row < MCP23017_LED_ROWS; row++) {
+      matrix.setPixel (row, column, true);
+    }
+
+    matrix.show();
+  }
+}
+
+//==============================================================================//
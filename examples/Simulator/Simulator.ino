@@ -0,0 +1,63 @@
+
+//==============================================================================//
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+
+//==============================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   BUTTON_PIN          3
+#define   LED_PIN             8
+#define   HOST_INT_PIN        2     // Left unconnected, the model calls the handler directly
+
+//==============================================================================//
+
+// A software model of the MCP23017 replaces the I2C bus. No hardware is needed.
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &simulator);
+
+volatile bool buttonPressed = false;
+
+//==============================================================================//
+
+void buttonIsr (int8_t pin) {
+  (void) pin;
+  buttonPressed = true;
+}
+
+//==============================================================================//
+
+void setup() {
+  Serial.begin (115200);
+
+  ioExpander.begin();
+  ioExpander.pinMode (BUTTON_PIN, INPUT_PULLUP);
+  ioExpander.pinMode (LED_PIN, OUTPUT);
+
+  // Route the INTA output of the model to the host interrupt handler of the object.
+  ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR);
+  simulator.attachOutput (MCP23017_PORT_A, ioExpander.callback);
+  ioExpander.attachInterrupt (BUTTON_PIN, buttonIsr, MCP23017_INT_FALLING);
+}
+
+//==============================================================================//
+
+void loop() {
+  // Press the button in the model, and let the library service the interrupt.
+  simulator.setInput (BUTTON_PIN, LOW);
+  ioExpander.dispatchInterrupt();
+
+  if (buttonPressed) {
+    buttonPressed = false;
+    ioExpander.togglePin (LED_PIN);
+    Serial.print (F("LED is "));
+    Serial.println (((simulator.outputs() >> LED_PIN) & 0x1U) ? F("ON") : F("OFF"));
+  }
+
+  simulator.setInput (BUTTON_PIN, HIGH);
+  delay (500);
+  ioExpander.dispatchInterrupt();
+}
+
+//==============================================================================//
@@ -11,56 +11,105 @@
 // Interrupts are fully supported for all IO expanders simultaneously. To makle this process
 // easier, the library maintains a list of all IO expanders on the bus, by saving pointers to
 // the IO expander objects in a global array `ioeList` and keeps track of the number of IO expanders
-// using the `ioeCount` variable.
+// using the `ioeCount` variable. An object takes the first free slot when constructed and frees it
+// when destroyed. The size of the list is set by `MCP23017_MAX_OBJECT`.
 CSE_MCP23017* ioeList [MCP23017_MAX_OBJECT] = {0};  // Pointers to all IO expander objects
 uint8_t ioeCount = 0;  // IO exapander object count
 
+// Each object has two interrupt lines, A and B, that can be attached to host MCU pins. Line
+// `(index << 1) + port` belongs to the object at `ioeList [index]`. Several lines can share the
+// same host pin (wired-OR open-drain outputs). Only the first line attached to a pin (the head)
+// has its handler attached to the host. The other lines are chained to it through `ioeLineNext`,
+// and the head handler signals every object in the chain. These are valid only for the lines
+// of registered objects, and are initialized by the constructor.
+int8_t ioeLinePin [MCP23017_LINE_COUNT];  // Host pin of each line, -1 if not attached
+uint8_t ioeLineMode [MCP23017_LINE_COUNT];  // Host interrupt mode of each head line
+bool ioeLineHead [MCP23017_LINE_COUNT];  // Set if the handler of the line is attached to the host
+volatile uint8_t ioeLineNext [MCP23017_LINE_COUNT];  // Next line sharing the host pin, or MCP23017_LINE_NONE
+
+// Interrupt events of all IO expanders that have the event queue enabled. The host interrupt
+// handlers are the only producer and `pollEvents()` is the only consumer.
+CSE_MCP23017_EventQueue ioeEventQueue;
+
 //============================================================================================//
 // Templates
 
-template <int index>  // Receives the index to the global arrays
+// The host interrupt handler of each interrupt line. It runs in interrupt context, so it must
+// not print or access the bus. The line index is a template parameter, so finding the object
+// takes no search. Every object sharing the host pin is signalled.
+template <uint8_t line>  // Receives the line index
 void callback() {
-  if (ioeList [index] != nullptr) {  // If the pointer is not zero
-    if (!ioeList [index]->interruptPending()) { // If an interupt is not already being served
-      debugPort.print (F("callback(): Callback invoked at "));
-      debugPort.println (index);
-      debugPort.print (F("callback(): Object is at 0x"));
-      debugPort.println (uint32_t (ioeList [index]), HEX);
-      debugPort.println();
-
-      // Activate the interrupt so that next time the ISR dispatcher is called
-      // the ISR will be executed.
-      ioeList [index]->interruptActive = true;
-      return;
-    }
-    else {
-      debugPort.print (F("callback(): \n--\nInterrupt pending at "));
-      debugPort.println (index);
-      debugPort.println (F("--\n"));
-      return;
+  uint32_t timestamp = micros();
+  uint8_t next = line;
+
+  do {
+    CSE_MCP23017* ioe = ioeList [next >> 1];
+
+    if (ioe != nullptr) {
+      ioe->signalInterrupt (timestamp);
     }
-  }
-  else {
-    debugPort.print (F("callback(): Callback error at "));
-    debugPort.println (index);
-    debugPort.println();
-  }
+
+    next = ioeLineNext [next];
+  } while (next != MCP23017_LINE_NONE);
 }
 
-// Array of callbacks for the host MCU
-hostCallback_t hostCallbackList [MCP23017_MAX_OBJECT] = {
-  callback <0>,
-  callback <1>,
-  callback <2>,
-  callback <3>,
-  callback <4>,
-  callback <5>
+// The following templates generate the table of host interrupt handlers, `callback <0>` to
+// `callback <MCP23017_LINE_COUNT - 1>`, at compile time. The table is constant-initialized,
+// so it is ready before any global object is constructed.
+template <uint8_t... lines>
+struct ioeLineSequence {};
+
+template <uint8_t count, uint8_t... lines>
+struct ioeLineSequenceBuilder : ioeLineSequenceBuilder <uint8_t (count - 1), uint8_t (count - 1), lines...> {};
+
+template <uint8_t... lines>
+struct ioeLineSequenceBuilder <0, lines...> {
+  typedef ioeLineSequence <lines...> type;
+};
+
+template <typename sequence>
+struct ioeCallbackTable;
+
+template <uint8_t... lines>
+struct ioeCallbackTable <ioeLineSequence <lines...>> {
+  static const hostCallback_t list [sizeof... (lines)];
+};
+
+template <uint8_t... lines>
+const hostCallback_t ioeCallbackTable <ioeLineSequence <lines...>>:: list [sizeof... (lines)] = {
+  callback <lines>...
 };
 
+// Array of callbacks for the host MCU
+typedef ioeCallbackTable <ioeLineSequenceBuilder <MCP23017_LINE_COUNT>::type> hostCallbackList;
 
 //============================================================================================//
 
-CSE_MCP23017:: CSE_MCP23017 (uint8_t rstPin, uint8_t address = MCP23017_ADDRESS) {
+CSE_MCP23017:: CSE_MCP23017 (uint8_t rstPin, uint8_t address) : CSE_MCP23017 (rstPin, address, &Wire) {
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Creates an IO expander object with a custom transport. All register transactions go
+ * through the transport. The transport must outlive the object.
+ * 
+ * @param rstPin The GPIO where the reset pin of the IOE is connected.
+ * @param address The I2C address of the IOE.
+ * @param busTransport The transport to use.
+ */
+CSE_MCP23017:: CSE_MCP23017 (uint8_t rstPin, uint8_t address, CSE_MCP23017_Transport *busTransport) : CSE_MCP23017 (rstPin, address, &Wire) {
+  transport = busTransport;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Creates an IO expander object on a specific I2C controller, such as `Wire1`.
+ * 
+ * @param rstPin The GPIO where the reset pin of the IOE is connected.
+ * @param address The I2C address of the IOE.
+ * @param wirePort The I2C controller to use. The controller must be initialized by the user.
+ */
+CSE_MCP23017:: CSE_MCP23017 (uint8_t rstPin, uint8_t address, TwoWire *wirePort) : wireTransport (wirePort) {
   deviceAddress = address;
   resetPin = rstPin;
   
@@ -76,19 +125,62 @@ CSE_MCP23017:: CSE_MCP23017 (uint8_t rstPin, uint8_t address = MCP23017_ADDRESS)
   deviceWriteError = false;
   interruptActive = false;
   stateReverted = true;
+
+  for (uint8_t i = 0; i < MCP23017_PINCOUNT; i++) {
+    holdoffList [i] = MCP23017_INT_HOLDOFF_AUTO;
+    rearmList [i] = MCP23017_INT_REARM_MS;
+  }
   
+  // Find a free slot in the global list. If the list is full, the object still works, but
+  // interrupts can not be configured.
+  ioeIndex = MCP23017_INDEX_NONE;
+  callback = nullptr;
+
+  for (uint8_t i = 0; i < MCP23017_MAX_OBJECT; i++) {
+    if (ioeList [i] == nullptr) {
+      ioeIndex = i;
+      break;
+    }
+  }
+
+  if (ioeIndex == MCP23017_INDEX_NONE) {
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("MCP23017 Error : Object list is full. Increase MCP23017_MAX_OBJECT."));
+    return;
+  }
+
+  for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+    uint8_t line = (ioeIndex << 1) + port;
+    ioeLinePin [line] = -1;
+    ioeLineHead [line] = false;
+    ioeLineNext [line] = MCP23017_LINE_NONE;
+  }
+
   // Assign the callback for this object
-  callback = hostCallbackList [ioeCount];
-  ioeIndex = ioeCount;
+  callback = hostCallbackList:: list [ioeIndex << 1];
 
   // Save the obj ptr to the global list, and update obj count
-  ioeList [ioeCount++] = this;
+  ioeList [ioeIndex] = this;
+  ioeCount++;
 }
 
 //--------------------------------------------------------------------------------------------//
 //destructor
-
+/**
+ * @brief Detaches the interrupt lines of the object and frees its slot in the global list.
+ * Host pins shared with other objects stay attached.
+ * 
+ */
 CSE_MCP23017:: ~CSE_MCP23017() {
+  if (ioeIndex == MCP23017_INDEX_NONE) {
+    return;
+  }
+
+  releaseHostLines();
+
+  noInterrupts();
+  ioeList [ioeIndex] = nullptr;
+  ioeCount--;
+  interrupts();
 }
 
 //============================================================================================//
@@ -106,7 +198,7 @@ void CSE_MCP23017:: reset() {
   addressMode = 0;
 
   // Clear the shadow copy of the register bank by writing all 0s.
-  for (int i = 0; i <= MCP23017_REGADDR_MAX; i++) {
+  for (uint8_t i = 0; i <= MCP23017_REGADDR_MAX; i++) {
     regBank [i] = 0;
   }
   
@@ -125,26 +217,183 @@ void CSE_MCP23017:: reset() {
   ::digitalWrite (resetPin, HIGH);
 }
 
+//============================================================================================//
+// Statistics. The record functions compile to nothing unless MCP23017_ENABLE_STATS is defined.
+
+void CSE_MCP23017:: recordTransfer (uint8_t response, size_t requested, size_t transferred) {
+#ifdef MCP23017_ENABLE_STATS
+  stats.transactions++;
+  stats.bytes += transferred;
+
+  // A read that stopped short counts as an underrun, even if the transport reported success.
+  if ((response != MCP23017_RESP_OK) && (response != MCP23017_ERROR_RF)) {
+    stats.nacks++;
+  }
+  else if ((response == MCP23017_ERROR_RF) || (transferred < requested)) {
+    stats.readUnderruns++;
+  }
+#else
+  (void) response; (void) requested; (void) transferred;
+#endif
+}
+
+void CSE_MCP23017:: recordService (uint32_t startTime) {
+#ifdef MCP23017_ENABLE_STATS
+  uint32_t duration = micros() - startTime;
+  stats.serviceCount++;
+  stats.serviceTimeTotal += duration;
+  stats.serviceTimeMax = (duration > stats.serviceTimeMax) ? duration : stats.serviceTimeMax;
+#else
+  (void) startTime;
+#endif
+}
+
+void CSE_MCP23017:: recordLatency (uint32_t eventTime) {
+#ifdef MCP23017_ENABLE_STATS
+  uint32_t latency = micros() - eventTime;
+  uint8_t bucket = 0;
+
+  // The bucket is floor(log2 (latency)). The builtin must match the 32-bit width: int is 16-bit
+  // on AVR, and long is 64-bit on most 64-bit hosts.
+  if (latency != 0) {
+    bucket = (sizeof (unsigned int) >= sizeof (uint32_t)) ? uint8_t (31 - __builtin_clz (latency)) : uint8_t (31 - __builtin_clzl (latency));
+  }
+
+  bucket = (bucket >= MCP23017_STATS_BUCKETS) ? (MCP23017_STATS_BUCKETS - 1) : bucket;
+  stats.latency [bucket]++;
+  stats.interruptsServiced++;
+#else
+  (void) eventTime;
+#endif
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns a copy of the runtime statistics of the object. The interrupt counters are
+ * updated in interrupt context, so the copy is taken with interrupts disabled. All values are 0
+ * unless `MCP23017_ENABLE_STATS` is defined before including the library.
+ * 
+ * @return ioeStats_t The statistics.
+ */
+ioeStats_t CSE_MCP23017:: snapshotStats() {
+  ioeStats_t copy = {};
+
+#ifdef MCP23017_ENABLE_STATS
+  noInterrupts();
+  copy = stats;
+  interrupts();
+#endif
+
+  return copy;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Clears the runtime statistics of the object.
+ * 
+ */
+void CSE_MCP23017:: resetStats() {
+#ifdef MCP23017_ENABLE_STATS
+  noInterrupts();
+  stats = ioeStats_t();
+  interrupts();
+#endif
+}
+
+//============================================================================================//
+/**
+ * @brief Replaces the transport of the object at runtime. Pass `NULL` to go back to the
+ * `TwoWire` controller set in the constructor.
+ * 
+ * @param busTransport The new transport, or `NULL`.
+ */
+void CSE_MCP23017:: setTransport (CSE_MCP23017_Transport *busTransport) {
+  transport = busTransport;
+}
+
+//--------------------------------------------------------------------------------------------//
+// The bus primitives. Every transaction of the object goes through one of these. When no custom
+// transport is set, the `TwoWire` transport member is called directly. It is a final class, so
+// the calls are resolved at compile time and can be inlined.
+
+uint8_t CSE_MCP23017:: busProbe() {
+  uint8_t response = (transport == nullptr) ? wireTransport.probe (deviceAddress) : transport->probe (deviceAddress);
+  recordTransfer (response, 0, 0);
+  return response;
+}
+
+uint8_t CSE_MCP23017:: busWrite (uint8_t regAddress, const uint8_t *data, size_t length) {
+  uint8_t response = (transport == nullptr) ? wireTransport.write (deviceAddress, regAddress, data, length) : transport->write (deviceAddress, regAddress, data, length);
+  recordTransfer (response, length, ((response == MCP23017_RESP_OK) ? length : 0));
+  return response;
+}
+
+uint8_t CSE_MCP23017:: busWriteThenRead (uint8_t regAddress, uint8_t *data, size_t length) {
+  uint8_t response = (transport == nullptr) ? wireTransport.writeThenRead (deviceAddress, regAddress, data, length) : transport->writeThenRead (deviceAddress, regAddress, data, length);
+  recordTransfer (response, length, ((response == MCP23017_RESP_OK) ? length : 0));
+  return response;
+}
+
+size_t CSE_MCP23017:: busReadN (uint8_t *data, size_t length) {
+  size_t count = (transport == nullptr) ? wireTransport.readN (deviceAddress, data, length) : transport->readN (deviceAddress, data, length);
+  recordTransfer (((count == length) ? MCP23017_RESP_OK : MCP23017_ERROR_RF), length, count);
+  return count;
+}
+
+size_t CSE_MCP23017:: busMaxLength() {
+  return (transport == nullptr) ? wireTransport.maxLength() : transport->maxLength();
+}
+
 //============================================================================================//
 //check if the device is present
 //hardware resets the device
 /**
- * @brief Checks the presence of the MCP23017 on the I2C bus by reading the ACK response.
+ * @brief Resets the device and checks its presence on the bus. On I2C, the presence is checked
+ * by reading the ACK response. If the transport needs any IOCON bits (such as HAEN on the
+ * MCP23S17), they are set after the reset, so `begin()` must be called again after `reset()`.
  * 
- * @return uint8_t The response from the Wire library.
+ * Without a reset pin, the IOE keeps its registers across a reset of the host, and can be left
+ * in BANK = 1 or SEQOP = 1. So IOCON is always written with BANK = 0 and SEQOP = 0 before any
+ * other register access. In BANK = 1, IOCON is at 0x05, which is GPINTENB in BANK = 0. So 0x05
+ * is written first, then IOCON at 0x0A, and finally GPINTENB is cleared if 0x05 was not zero.
+ * 
+ * @return uint8_t The response from the transport.
  */
 uint8_t CSE_MCP23017:: begin() {
-  Wire.beginTransmission (deviceAddress);
-  uint8_t response = Wire.endTransmission(); // Read ACK
+  reset();
+
+  uint8_t response = (transport == nullptr) ? MCP23017_RESP_OK : transport->begin (deviceAddress);
+
+  if (response == MCP23017_RESP_OK) {
+    response = busProbe(); // Read ACK
+  }
   
   if (response == 0) {
-    debugPort.println (F("begin(): MCP23017 is found on the bus."));
+    MCP23017_LOGLN_INFO (MCP23017_LOG_BUS, F("begin(): MCP23017 is found on the bus."));
+
+    if (transport != nullptr) {
+      regBank [MCP23017_REG_IOCON] |= transport->ioconBits();
+      regBank [MCP23017_REG_IOCON_] = regBank [MCP23017_REG_IOCON];
+    }
+
+    // Only HAEN goes to 0x05, so that the device keeps responding to its hardware address.
+    uint8_t ioconByte = regBank [MCP23017_REG_IOCON] & (~((1U << MCP23017_BIT_BANK) | (1U << MCP23017_BIT_SEQOP)));
+    uint8_t groupByte = ioconByte & (1U << MCP23017_BIT_HAEN);
+
+    response = write (TRANSLATE (MCP23017_REG_IOCON), groupByte, false);
+
+    if (response == MCP23017_RESP_OK) {
+      response = write (MCP23017_REG_IOCON, ioconByte, false);
+    }
+
+    if ((response == MCP23017_RESP_OK) && (groupByte != 0)) {
+      response = write (MCP23017_REG_GPINTENB, regBank [MCP23017_REG_GPINTENB], false);
+    }
   }
   else {
-    debugPort.println (F("begin(): MCP23017 is not found on the bus."));
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_BUS, F("begin(): MCP23017 is not found on the bus."));
   }
 
-  reset();
   return response;
 }
 
@@ -152,7 +401,10 @@ uint8_t CSE_MCP23017:: begin() {
 /**
  * @brief Directly writes a sequence of bytes to the IOE. These values are not saved to the
  * local register bank. You must call `readAll()` to update the local register bank.
- * If translateAddress is false, absolute register address will be used.
+ * The starting address is translated automatically when the IOE is in BANK = 1 mode. The bytes
+ * are written to the consecutive addresses of the device from there, so the caller must take
+ * care of the bank and address modes. Use `writeBurst()` for that.
+ * Writes longer than the Wire buffer are split into multiple transactions.
  * 
  * @param regAddress Starting register address.
  * @param buffer A pointer to a byte buffer.
@@ -162,18 +414,44 @@ uint8_t CSE_MCP23017:: begin() {
  * @return uint8_t Response from the Wire library.
  */
 uint8_t CSE_MCP23017:: write (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length, bool translateAddress) {
-  Wire.beginTransmission (deviceAddress);
-  Wire.write (regAddress);
-  
-  for (uint8_t i = bufferOffset; i < (bufferOffset + length); i++) {
-    Wire.write (buffer [i]);
+  if (translateAddress || (bankMode == GROUP)) {  // If bankmode = 1 (group)
+    return writeChunked (TRANSLATE (regAddress), &buffer [bufferOffset], length);
   }
+  
+  return writeChunked (regAddress, &buffer [bufferOffset], length);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a sequence of bytes starting from an absolute device register address. If the
+ * data does not fit in the Wire buffer, it is split into multiple transactions. In the sequential
+ * mode, each transaction continues from where the previous one ended. In the byte mode, each
+ * transaction starts from the same register.
+ * 
+ * @param deviceRegister The absolute register address in the current bank mode.
+ * @param data The bytes to write.
+ * @param length The number of bytes to write.
+ * @return uint8_t Response from the Wire library. The first error stops the write. Nothing is
+ * written if the length is 0.
+ */
+uint8_t CSE_MCP23017:: writeChunked (uint8_t deviceRegister, const uint8_t *data, size_t length) {
+  const size_t chunkSize = busMaxLength();
+  size_t position = 0;
+  uint8_t response = MCP23017_RESP_OK;
 
-  uint8_t response = Wire.endTransmission();
+  while (position < length) {
+    size_t count = ((length - position) > chunkSize) ? chunkSize : (length - position);
 
-  if (response != MCP23017_RESP_OK) {
-    writeError (true);
+    response = busWrite (uint8_t (deviceRegister + ((addressMode == 0) ? position : 0)), &data [position], count);
+
+    if (response != MCP23017_RESP_OK) {
+      writeError (true);
+      break;
+    }
+
+    position += count;
   }
+
   return response;
 }
 
@@ -181,7 +459,8 @@ uint8_t CSE_MCP23017:: write (uint8_t regAddress, uint8_t *buffer, uint8_t buffe
 /**
  * @brief Directly writes a single byte to the IOE. The data is not saved in the local register bank.
  * You must call `readAll()` to update the local register bank.
- * Bank or Sequential mode doesn't matter when writing a single byte.
+ * Bank or Sequential mode doesn't matter when writing a single byte. The address is always
+ * in the BANK = 0 layout, and is translated automatically when the IOE is in BANK = 1 mode.
  * 
  * @param regAddress Register address.
  * @param data Data to be written. 
@@ -190,17 +469,11 @@ uint8_t CSE_MCP23017:: write (uint8_t regAddress, uint8_t *buffer, uint8_t buffe
  */
 uint8_t CSE_MCP23017:: write (uint8_t regAddress, uint8_t data, bool translateAddress) {
   if (regAddress <= MCP23017_REGADDR_MAX) {  // Check if the address is in range
-    Wire.beginTransmission (deviceAddress); // Write device address
-
-    if (translateAddress) {  // If bankmode = 1 (group)
-      Wire.write (TRANSLATE (regAddress));  // Translate the address for both port A and B
-    }
-    else {
-      Wire.write (regAddress);
+    if (translateAddress || (bankMode == GROUP)) {  // If bankmode = 1 (group)
+      regAddress = TRANSLATE (regAddress);  // Translate the address for both port A and B
     }
 
-    Wire.write (data);
-    uint8_t response = Wire.endTransmission();
+    uint8_t response = busWrite (regAddress, &data, 1);
 
     if (response != MCP23017_RESP_OK) {
       writeError (true);
@@ -213,36 +486,143 @@ uint8_t CSE_MCP23017:: write (uint8_t regAddress, uint8_t data, bool translateAd
   return MCP23017_ERROR_OOR;  // Address out of range
 }
 
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a single byte to a register of the IOE. If a batch is active, the byte is only
+ * saved to the local register bank and the register is marked dirty. It will be written to the
+ * device when `commit()` is called. The caller is responsible for saving the value to the local
+ * register bank when the response is OK, as with `write()`.
+ * 
+ * @param regAddress Register address.
+ * @param data Data to be written.
+ * @param translateAddress Whether to translate the register address or not.
+ * @return uint8_t Response from the Wire library. Always `MCP23017_RESP_OK` during a batch.
+ */
+uint8_t CSE_MCP23017:: writeRegister (uint8_t regAddress, uint8_t data, bool translateAddress) {
+  if (batchActive && (regAddress <= MCP23017_REGADDR_MAX)) {
+    regBank [regAddress] = data;
+    dirtyMask |= (1UL << regAddress);
+    return MCP23017_RESP_OK;
+  }
+
+  return write (regAddress, data, translateAddress);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a pair of port A and port B registers in a single transaction. The low byte of
+ * the word goes to the port A register and the high byte to the port B register. If the write
+ * is successful, or a batch is active, the values are saved to the local register bank.
+ * 
+ * @param regAddress Address of the port A register.
+ * @param word The value to write. Low byte = Port A, high byte = Port B.
+ * @return uint8_t Response from the Wire library. Always `MCP23017_RESP_OK` during a batch.
+ */
+uint8_t CSE_MCP23017:: writeRegisterPair (uint8_t regAddress, uint16_t word) {
+  uint8_t pairBuffer [2] = {uint8_t (word & 0xFFU), uint8_t (word >> 8)};
+  uint8_t response = MCP23017_RESP_OK;
+
+  if (batchActive) {
+    dirtyMask |= (0x3UL << regAddress);
+  }
+  else {
+    response = writeBurst (regAddress, pairBuffer, 0, 2);
+  }
+
+  if (response == MCP23017_RESP_OK) {
+    regBank [regAddress] = pairBuffer [0];
+    regBank [regAddress + 1] = pairBuffer [1];
+  }
+
+  return response;
+}
+
 //============================================================================================//
 /**
  * @brief Updates all IOE registers with the local register bank values.
+ * The registers are written with `writeBurst()`, so the number of transactions depends on
+ * the bank and address modes.
  * 
  * TODO: Rename this function to `writeAll()`.
  * 
- * @param translateAddress Whether to translate the register address or not.
+ * @param translateAddress Not used. Address translation follows the bank mode.
  * @return uint8_t Response from the Wire library.
  */
 uint8_t CSE_MCP23017:: write (bool translateAddress) {
-  Wire.beginTransmission (deviceAddress);
-  Wire.write (TRANSLATE (MCP23017_REG_IODIRA));
-  
-  for (int i = 0; i <= MCP23017_REGADDR_MAX; i++) {
-    if (translateAddress) {
-      // In bank mode, or when address translation is needed,
-      // we need to fetch from the correct locations in the local reg bank
-      // writes to device sequentially, addressMode should be 0
-      Wire.write (regBank [TRANSLATE (i)]);
-    }
-    else {
-      //otherwise read values in sequential order
-      Wire.write (regBank [i]);
+  (void) translateAddress;
+  return writeBurst (MCP23017_REG_IODIRA, regBank, MCP23017_REG_IODIRA, (MCP23017_REGADDR_MAX + 1));
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a range of registers to the device with as few transactions as the bank and
+ * address modes allow. Unlike the multi-byte `write()`, the register range and the buffer are
+ * always in the layout of the local register bank (BANK = 0), whatever the mode of the IOE is.
+ * 
+ * - BANK = 0, SEQOP = 0 : A single transaction.
+ * - BANK = 1, SEQOP = 0 : One transaction per port, since each port is sequential in the device.
+ * - BANK = 0, SEQOP = 1 : One transaction per A/B register pair, since the address pointer toggles within the pair.
+ * - BANK = 1, SEQOP = 1 : One transaction per register.
+ * 
+ * @param regAddress Starting register address in the local register bank.
+ * @param buffer A pointer to a byte buffer.
+ * @param bufferOffset A position offset in the buffer where the reading will begin from.
+ * @param length The number of registers to write.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_OOR` or the largest error code from the Wire library.
+ */
+uint8_t CSE_MCP23017:: writeBurst (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length) {
+  if ((length == 0) || ((regAddress + length) > (MCP23017_REGADDR_MAX + 1))) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  // The device layout is the same as the local register bank.
+  if ((bankMode == PAIR) && (addressMode == 0)) {
+    return write (regAddress, buffer, bufferOffset, length);
+  }
+
+  uint8_t response = MCP23017_RESP_OK;
+  uint8_t status = 0;
+
+  if (addressMode == 0) { // BANK = 1, sequential
+    // Port A registers are at even addresses and port B registers are at odd addresses of the
+    // local register bank. Gather the registers of each port and write them at once.
+    uint8_t portBuffer [(MCP23017_REGADDR_MAX + 2) / 2];
+
+    for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+      uint8_t count = 0;
+      uint8_t firstAddress = 0;
+
+      for (uint8_t i = 0; i < length; i++) {
+        if (((regAddress + i) & 0x1U) == port) {
+          if (count == 0) {
+            firstAddress = regAddress + i;
+          }
+          portBuffer [count++] = buffer [bufferOffset + i];
+        }
+      }
+
+      if (count > 0) {
+        status = write (firstAddress, portBuffer, 0, count);
+        response = (status > response) ? status : response;
+      }
     }
+
+    return response;
   }
 
-  uint8_t response = Wire.endTransmission();
-  
-  if (response != MCP23017_RESP_OK) {
-    writeError (true);
+  // Byte mode. Only the A/B pair can be written at once in BANK = 0.
+  uint8_t i = 0;
+
+  while (i < length) {
+    uint8_t count = 1;
+
+    if ((bankMode == PAIR) && (((regAddress + i) & 0x1U) == 0) && ((i + 1) < length)) {
+      count = 2;
+    }
+
+    status = write ((regAddress + i), buffer, (bufferOffset + i), count);
+    response = (status > response) ? status : response;
+    i += count;
   }
 
   return response;
@@ -261,32 +641,127 @@ uint8_t CSE_MCP23017:: write (bool translateAddress) {
  */
 uint8_t CSE_MCP23017:: read (uint8_t regAddress, bool translateAddress) {
   if (regAddress <= MCP23017_REGADDR_MAX) {  // Check if address is in range
-    Wire.beginTransmission (deviceAddress);
-    if (translateAddress) {  // If bankmode = 1 (group)
-      Wire.write (TRANSLATE (regAddress));  // Translate address for both port A and B
-    }
-    else {
-      Wire.write (regAddress);
+    if (translateAddress || (bankMode == GROUP)) {  // If bankmode = 1 (group)
+      regAddress = TRANSLATE (regAddress);  // Translate address for both port A and B
     }
-    Wire.endTransmission();
 
-    Wire.requestFrom (deviceAddress, 1, true); // Address, Quantity and Bus release
+    uint8_t data = 0;
 
-    if (Wire.available() == 1) {
-      return uint8_t (Wire.read());
+    if (busWriteThenRead (regAddress, &data, 1) == MCP23017_RESP_OK) {
+      return data;
     }
     
-    debugPort.print (F("read(): Device 0x"));
-    debugPort.print (deviceAddress, HEX);
-    debugPort.println (F(" not responding"));
+    MCP23017_LOG_ERROR (MCP23017_LOG_BUS, F("read(): Device 0x"));
+    MCP23017_LOG_ERROR (MCP23017_LOG_BUS, deviceAddress, HEX);
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_BUS, F(" not responding"));
     readError (true);
     return 0xFF;
   }
 
-  debugPort.println (F("read(): MCP23017 Error - Value out of range"));
+  MCP23017_LOGLN_ERROR (MCP23017_LOG_BUS, F("read(): MCP23017 Error - Value out of range"));
   return MCP23017_ERROR_OOR;  // Address out of range
 }
 
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads a sequence of registers from the device into a buffer, using the address
+ * auto-increment of the IOE. Returns `MCP23017_RESP_OK` only if all the bytes were received.
+ * As with the multi-byte `write()`, only the starting address is translated. Use `readBurst()`
+ * to read a range of registers in the layout of the local register bank.
+ * 
+ * @param regAddress Starting register address.
+ * @param buffer A pointer to a byte buffer.
+ * @param bufferOffset A position offset in the buffer where the writing will begin from.
+ * @param length The number of bytes to read.
+ * @param translateAddress Whether to translate the register address or not.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_RF` or `MCP23017_ERROR_OOR`.
+ */
+uint8_t CSE_MCP23017:: read (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length, bool translateAddress) {
+  if ((regAddress <= MCP23017_REGADDR_MAX) && (length > 0)) {
+    if (translateAddress || (bankMode == GROUP)) {
+      regAddress = TRANSLATE (regAddress);
+    }
+
+    if (busWriteThenRead (regAddress, &buffer [bufferOffset], length) == MCP23017_RESP_OK) {
+      return MCP23017_RESP_OK;
+    }
+
+    readError (true);
+    return MCP23017_ERROR_RF;
+  }
+
+  return MCP23017_ERROR_OOR;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads a range of registers from the device with as few transactions as the bank and
+ * address modes allow. This is the counterpart of `writeBurst()`. The register range and the
+ * buffer are always in the layout of the local register bank (BANK = 0).
+ * 
+ * @param regAddress Starting register address in the local register bank.
+ * @param buffer A pointer to a byte buffer.
+ * @param bufferOffset A position offset in the buffer where the writing will begin from.
+ * @param length The number of registers to read.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_RF` or `MCP23017_ERROR_OOR`.
+ */
+uint8_t CSE_MCP23017:: readBurst (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length) {
+  if ((length == 0) || ((regAddress + length) > (MCP23017_REGADDR_MAX + 1))) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  // The device layout is the same as the local register bank.
+  if ((bankMode == PAIR) && (addressMode == 0)) {
+    return read (regAddress, buffer, bufferOffset, length);
+  }
+
+  uint8_t response = MCP23017_RESP_OK;
+  uint8_t status = 0;
+
+  if (addressMode == 0) { // BANK = 1, sequential
+    uint8_t portBuffer [(MCP23017_REGADDR_MAX + 2) / 2];
+
+    for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+      uint8_t firstIndex = ((regAddress & 0x1U) == port) ? 0 : 1; // First register of the port in the range
+      
+      if (firstIndex >= length) {
+        continue;
+      }
+
+      uint8_t count = ((length - firstIndex) + 1) / 2;
+      status = read ((regAddress + firstIndex), portBuffer, 0, count);
+
+      if (status == MCP23017_RESP_OK) {
+        // Scatter the bytes back to every other location.
+        for (uint8_t i = 0; i < count; i++) {
+          buffer [bufferOffset + firstIndex + (2 * i)] = portBuffer [i];
+        }
+      }
+
+      response = (status > response) ? status : response;
+    }
+
+    return response;
+  }
+
+  // Byte mode. Only the A/B pair can be read at once in BANK = 0.
+  uint8_t i = 0;
+
+  while (i < length) {
+    uint8_t count = 1;
+
+    if ((bankMode == PAIR) && (((regAddress + i) & 0x1U) == 0) && ((i + 1) < length)) {
+      count = 2;
+    }
+
+    status = read ((regAddress + i), buffer, (bufferOffset + i), count);
+    response = (status > response) ? status : response;
+    i += count;
+  }
+
+  return response;
+}
+
 //============================================================================================//
 /**
  * @brief Returns the last read error state of the I2C read operation.
@@ -347,29 +822,245 @@ void CSE_MCP23017:: writeError (bool err) {
 
 //============================================================================================//
 /**
- * @brief Read all registers from the device and store them in the local register bank.
+ * @brief Sets how much the local register bank is trusted by the read-modify-write operations
+ * such as `pinMode()`, `digitalWrite()`, `togglePin()` and `setPinInputPolarity()`.
  * 
- * @param translateAddress Whether to translate the register address or not.
- * @return uint8_t Returns `0` on success.
+ * `MCP23017_CACHE_READTHROUGH` reads the register from the device before every modification.
+ * This is the default and is safe even if something else writes to the IOE.
+ * `MCP23017_CACHE_TRUSTED` uses the local register bank as is and only writes the new value.
+ * This saves one or more I2C read transactions per call, but the local register bank must
+ * be in sync with the device. After `begin()`, it is only if the reset pin is connected. Without
+ * a reset pin, the IOE keeps its registers across a reset of the host, so call `readAll()`
+ * before switching to this policy.
+ * `MCP23017_CACHE_VERIFY` works like the trusted mode, but falls back to a read-through
+ * once every `verifyInterval` milliseconds.
+ * 
+ * @param policy The cache policy. Can be `MCP23017_CACHE_READTHROUGH`, `MCP23017_CACHE_TRUSTED` or `MCP23017_CACHE_VERIFY`.
+ * @param verifyInterval The verify interval in milliseconds. Only used with `MCP23017_CACHE_VERIFY`.
+ * @return uint8_t `MCP23017_RESP_OK` or `MCP23017_ERROR_OOR`.
  */
-uint8_t CSE_MCP23017:: readAll (bool translateAddress) {
-  Wire.beginTransmission (deviceAddress); // Write device address
-  Wire.write (MCP23017_REG_IODIRA);
-  Wire.endTransmission();
+uint8_t CSE_MCP23017:: setCachePolicy (uint8_t policy, uint32_t verifyInterval) {
+  if (policy <= MCP23017_CACHE_VERIFY) {
+    cachePolicy = policy;
+    cacheVerifyInterval = verifyInterval;
+    cacheVerifyTime = millis();
+    return MCP23017_RESP_OK;
+  }
 
-  Wire.requestFrom (deviceAddress, 22);
+  return MCP23017_ERROR_OOR;
+}
 
-  for (int i = 0; i <= MCP23017_REGADDR_MAX; i++) {
-    uint8_t incomingByte = Wire.read();
-    if (translateAddress) {
-      regBank [TRANSLATE (i)] = incomingByte;
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the current cache policy.
+ * 
+ * @return uint8_t The cache policy.
+ */
+uint8_t CSE_MCP23017:: getCachePolicy() {
+  return cachePolicy;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Determines if a read-modify-write operation has to read the registers from the device
+ * before modifying them, as per the cache policy. In the verify mode, calling this function
+ * also restarts the verify interval when a read is due.
+ * 
+ * @return true The registers must be read from the device.
+ * @return false The local register bank can be used as is.
+ */
+bool CSE_MCP23017:: cacheReadRequired() {
+  // During a batch, the local register bank holds values not yet written to the device.
+  if ((cachePolicy == MCP23017_CACHE_TRUSTED) || batchActive) {
+    return false;
+  }
+  
+  if (cachePolicy == MCP23017_CACHE_VERIFY) {
+    if ((millis() - cacheVerifyTime) < cacheVerifyInterval) {
+      return false;
     }
-    else {
-      regBank [i] = incomingByte;
+    cacheVerifyTime = millis();
+  }
+
+  return true;
+}
+
+//============================================================================================//
+/**
+ * @brief Starts a batch of register modifications. Until `commit()` is called, `pinMode()`,
+ * `portMode()`, `digitalWrite()`, `portWrite()`, `togglePin()`, `togglePort()`,
+ * `setPinInputPolarity()`, `setPortInputPolarity()` and `attachInterrupt()` only modify
+ * the local register bank and mark the registers dirty. No I2C transactions are made.
+ * 
+ * If the cache policy requires it, the writable registers are first read from the device in
+ * two bursts so that the batch starts from the actual device state.
+ * 
+ * @return uint8_t `MCP23017_RESP_OK` or the error from reading the registers.
+ */
+uint8_t CSE_MCP23017:: beginBatch() {
+  uint8_t response = MCP23017_RESP_OK;
+
+  if ((!batchActive) && cacheReadRequired()) {
+    // Only the control registers and the output latches. Reading GPIO or INTCAP clears
+    // pending interrupts, and INTF is read-only.
+    response = readBurst (MCP23017_REG_IODIRA, regBank, MCP23017_REG_IODIRA, (MCP23017_REG_GPPUB - MCP23017_REG_IODIRA + 1));
+
+    if (response == MCP23017_RESP_OK) {
+      response = readBurst (MCP23017_REG_OLATA, regBank, MCP23017_REG_OLATA, 2);
     }
   }
 
-  return 0;
+  batchActive = true;
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes all the dirty registers to the device and ends the batch. Dirty registers that
+ * are next to each other are written in a single transaction using the address auto-increment
+ * of the IOE. Small gaps of clean registers are bridged by re-writing their local values when
+ * that is cheaper than starting a new transaction. `IOCON` and the GPIO registers are never
+ * bridged. Registers that fail to write remain dirty so that `commit()` can be retried.
+ * 
+ * @return uint8_t `MCP23017_RESP_OK` or the largest error code from the Wire library.
+ */
+uint8_t CSE_MCP23017:: commit() {
+  uint8_t response = MCP23017_RESP_OK;
+  uint8_t regAddress = 0;
+
+  batchActive = false;
+
+  while (regAddress <= MCP23017_REGADDR_MAX) {
+    if ((dirtyMask & (1UL << regAddress)) == 0) {
+      regAddress++;
+      continue;
+    }
+
+    // Find the last dirty register that can be reached from here in the same burst.
+    uint8_t lastAddress = regAddress;
+
+    for (uint8_t i = regAddress + 1; i <= MCP23017_REGADDR_MAX; i++) {
+      if ((dirtyMask & (1UL << i)) != 0) {
+        lastAddress = i;
+      }
+      else if ((i == MCP23017_REG_IOCON) || (i == MCP23017_REG_IOCON_) ||
+               (i == MCP23017_REG_GPIOA) || (i == MCP23017_REG_GPIOB) ||
+               (unsigned (i - lastAddress) > MCP23017_BATCH_MAX_GAP)) {  // i is always past lastAddress
+        break;
+      }
+    }
+
+    uint8_t length = lastAddress - regAddress + 1;
+    uint8_t burstResponse = writeBurst (regAddress, regBank, regAddress, length);
+
+    if (burstResponse == MCP23017_RESP_OK) {
+      for (uint8_t i = regAddress; i <= lastAddress; i++) {
+        dirtyMask &= ~(1UL << i);
+      }
+    }
+    else if (burstResponse > response) {
+      response = burstResponse;
+    }
+
+    regAddress = lastAddress + 1;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns whether a batch is active or not.
+ * 
+ * @return true A batch is active.
+ * @return false No batch is active.
+ */
+bool CSE_MCP23017:: batchPending() {
+  return batchActive;
+}
+
+//============================================================================================//
+/**
+ * @brief Read all registers from the device and store them in the local register bank.
+ * The registers are read with `readBurst()`, so the number of transactions depends on
+ * the bank and address modes.
+ * 
+ * @param translateAddress Not used. Address translation follows the bank mode.
+ * @return uint8_t Returns `0` on success.
+ */
+uint8_t CSE_MCP23017:: readAll (bool translateAddress) {
+  (void) translateAddress;
+  return readBurst (MCP23017_REG_IODIRA, regBank, MCP23017_REG_IODIRA, (MCP23017_REGADDR_MAX + 1));
+}
+
+//============================================================================================//
+/**
+ * @brief Sets the register access mode of the IOE by writing the `BANK` and `SEQOP` bits of
+ * the `IOCON` register. The local register bank always stays in the BANK = 0 layout, and all
+ * functions translate the register addresses as per the mode set here.
+ * 
+ * In the BANK = 1 (`MCP23017_BANK_GROUP`) mode, the registers of each port are sequential, which
+ * allows writing all the registers of a port in a single burst. In the byte mode
+ * (`MCP23017_ADDR_BYTE`), the address pointer is not incremented after each byte. This allows
+ * reading or writing the same register (or the same A/B pair in BANK = 0) repeatedly without
+ * sending the address again.
+ * 
+ * The mode can not be changed while a batch is active, because the batch defers all bus
+ * transactions to `commit()`. Call `commit()` first.
+ * 
+ * @param bank `MCP23017_BANK_PAIR` (BANK = 0) or `MCP23017_BANK_GROUP` (BANK = 1).
+ * @param sequence `MCP23017_ADDR_SEQUENTIAL` (SEQOP = 0) or `MCP23017_ADDR_BYTE` (SEQOP = 1).
+ * @return uint8_t The I2C response code, `MCP23017_ERROR_OOR` for an invalid mode, or
+ * `MCP23017_ERROR_OF` if a batch is active.
+ */
+uint8_t CSE_MCP23017:: setAccessMode (uint8_t bank, uint8_t sequence) {
+  if (batchActive) {
+    return MCP23017_ERROR_OF;
+  }
+
+  if ((bank <= MCP23017_BANK_GROUP) && (sequence <= MCP23017_ADDR_BYTE)) {
+    if (cacheReadRequired()) {
+      regBank [MCP23017_REG_IOCON] = read (MCP23017_REG_IOCON, false);
+    }
+
+    uint8_t regByte = regBank [MCP23017_REG_IOCON] & (~((1U << MCP23017_BIT_BANK) | (1U << MCP23017_BIT_SEQOP)));
+    regByte |= (bank << MCP23017_BIT_BANK) | (sequence << MCP23017_BIT_SEQOP);
+
+    // The IOCON address is translated as per the current mode. The new mode is
+    // effective from the next transaction.
+    uint8_t response = write (MCP23017_REG_IOCON, regByte, false);
+
+    if (response == MCP23017_RESP_OK) {
+      regBank [MCP23017_REG_IOCON] = regByte;
+      regBank [MCP23017_REG_IOCON_] = regByte;  // Both addresses map to the same register
+      bankMode = (bank == MCP23017_BANK_GROUP) ? GROUP : PAIR;
+      addressMode = sequence;
+    }
+
+    return response;
+  }
+
+  return MCP23017_ERROR_OOR;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the current bank mode.
+ * 
+ * @return uint8_t `MCP23017_BANK_PAIR` or `MCP23017_BANK_GROUP`.
+ */
+uint8_t CSE_MCP23017:: getBankMode() {
+  return (bankMode == GROUP) ? MCP23017_BANK_GROUP : MCP23017_BANK_PAIR;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the current address mode.
+ * 
+ * @return uint8_t `MCP23017_ADDR_SEQUENTIAL` or `MCP23017_ADDR_BYTE`.
+ */
+uint8_t CSE_MCP23017:: getAddressMode() {
+  return addressMode;
 }
 
 //============================================================================================//
@@ -459,21 +1150,22 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
     uint8_t pullupModeByte = 0;
     uint8_t response_1, response_2 = 0;
 
-    debugPort.print (F("pinMode(): Setting pin mode at "));
-    debugPort.println (pin);
-    debugPort.println (F("pinMode(): Reading registers"));
+    MCP23017_LOG_DEBUG (MCP23017_LOG_CONFIG, F("pinMode(): Setting pin mode at "));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, pin);
     
-    // Read the values from the device and store it at local register bank.
+    // Read the values from the device and store it at local register bank,
+    // unless the cache policy allows us to use the local register bank as is.
     // Bank Mode can tell if an address translation is needed or not.
-    regBank [MCP23017_REG_IODIRA] = read (MCP23017_REG_IODIRA, false);
-    regBank [MCP23017_REG_IODIRB] = read (MCP23017_REG_IODIRB, false);
-    regBank [MCP23017_REG_GPPUA] = read (MCP23017_REG_GPPUA, false);
-    regBank [MCP23017_REG_GPPUB] = read (MCP23017_REG_GPPUB, false);
-    // debugPort.println (F("Success"));
-    printOperationStatus (readError());
+    if (cacheReadRequired()) {
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("pinMode(): Reading registers"));
+      regBank [MCP23017_REG_IODIRA + (pin >> 3)] = read ((MCP23017_REG_IODIRA + (pin >> 3)), false);
+      regBank [MCP23017_REG_GPPUA + (pin >> 3)] = read ((MCP23017_REG_GPPUA + (pin >> 3)), false);
+      // debugPort.println (F("Success"));
+      printOperationStatus (!readError());
+    }
     
     if (mode == OUTPUT) { // If OUTPUT
-      debugPort.println (F("pinMode(): Mode is OUTPUT"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("pinMode(): Mode is OUTPUT"));
       // Since identical registers are paired, they sit next to each other in sequential mode,
       // shifting right 3 times is dividing by 8.
       // It finds if a number is less than or greater than 8
@@ -488,13 +1180,13 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
       pinModeByte = regBank [pin >> 3] & (~(0x1U << (pin & 0x7U))); //write 0
     }
     else { // If INPUT
-      debugPort.println (F("pinMode(): Mode is INPUT"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("pinMode(): Mode is INPUT"));
       // To set as INPUT, we need to write 1.
       // This is done by ORing a 1, eg 00100000.
       pinModeByte = regBank [pin >> 3] | (0x1U << (pin & 0x7U));  // Set port IO register, write 1
 
       if (mode == INPUT_PULLUP) {  // Enable pull-up
-        debugPort.println (F("pinMode(): With PULL-UP"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("pinMode(): With PULL-UP"));
         pullupModeByte = regBank [MCP23017_REG_GPPUA + (pin >> 3)] | (0x1U << (pin & 0x7U));  //write 1
       }
       else {  // Disable pull-up
@@ -509,9 +1201,9 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
     // and this assumes false = 0, and true = 1 for the compiler.
 
     // Write the pin mode register.
-    debugPort.println (F("Writing IODIR register"));
-    response_1 = write ((MCP23017_REG_IODIRA + (pin >> 3)), pinModeByte, false); // Write single byte
-    debugPort.println (F("Success"));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing IODIR register"));
+    response_1 = writeRegister ((MCP23017_REG_IODIRA + (pin >> 3)), pinModeByte, false); // Write single byte
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
 
     if (response_1 == MCP23017_RESP_OK) {  // Save to register bank only if the response is OK
       // Since identical registers are sequentially paired, they sits next to each other.
@@ -519,7 +1211,7 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
       // Do AND or OR appropreatly on the register bank value.
       // regBank [MCP23017_REG_IODIRA + (pin >> 3)] = (mode == OUTPUT) ? (regBank[MCP23017_REG_IODIRA + (pin >> 3)] & pinModeByte) : (regBank[MCP23017_REG_IODIRA + (pin >> 3)]) | pinModeByte;  //save the new value to local reg bank
       
-      debugPort.println (F("Saving values"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Saving values"));
       regBank [MCP23017_REG_IODIRA + (pin >> 3)] = pinModeByte;
       // if (mode == OUTPUT) { // If OUTPUT
       //   regBank [MCP23017_REG_IODIRA + (pin >> 3)] = regBank[MCP23017_REG_IODIRA + (pin >> 3)] & pinModeByte;  // Write 0
@@ -532,9 +1224,9 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
     // Write the pull-up register value.
     // To enable it for INPUT_PULLUP or to disable it for INPUT.
     if ((mode == INPUT_PULLUP) || (mode == INPUT)) {
-      debugPort.println (F("Writing GPPU register"));
-      response_2 = write ((MCP23017_REG_GPPUA + (pin >> 3)), pullupModeByte, false); //write single byte
-      debugPort.println (F("Success"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing GPPU register"));
+      response_2 = writeRegister ((MCP23017_REG_GPPUA + (pin >> 3)), pullupModeByte, false); //write single byte
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
 
       if (response_2 == MCP23017_RESP_OK) {  // Save to the register bank only if response is OK
         regBank [MCP23017_REG_GPPUA + (pin >> 3)] = pullupModeByte;
@@ -547,7 +1239,7 @@ uint8_t CSE_MCP23017:: pinMode (uint8_t pin, uint8_t mode) {
       }
     }
 
-    debugPort.println (F("Pin mode configured\n"));
+    MCP23017_LOGLN_INFO (MCP23017_LOG_CONFIG, F("Pin mode configured\n"));
 
     // Returns the largest of the error code.
     return (response_1 > response_2) ? response_1 : response_2;  // Return I2C response code
@@ -586,14 +1278,14 @@ uint8_t CSE_MCP23017:: portMode (uint8_t port, uint8_t mode) {
 
     // Write the pin mode register.
     // Here, we don't have to shift right 3 times since port value is either 0 or 1.
-    response_1 = write ((MCP23017_REG_IODIRA + port), portModeByte, false); // Write single byte
+    response_1 = writeRegister ((MCP23017_REG_IODIRA + port), portModeByte, false); // Write single byte
 
     if (response_1 == MCP23017_RESP_OK) {  // Save to reg bank only if response is OK
       regBank [MCP23017_REG_IODIRA + port] = portModeByte;
     }
 
     if (mode == INPUT_PULLUP) {
-      response_2 = write ((MCP23017_REG_GPPUA + port), pullupModeByte, false); // Write single byte
+      response_2 = writeRegister ((MCP23017_REG_GPPUA + port), pullupModeByte, false); // Write single byte
       
       if (response_2 == MCP23017_RESP_OK) {
         regBank [MCP23017_REG_GPPUA + port] = pullupModeByte;
@@ -620,10 +1312,11 @@ uint8_t CSE_MCP23017:: portMode (uint8_t port, uint8_t mode) {
  */
 uint8_t CSE_MCP23017:: digitalWrite (uint8_t pin, uint8_t value) {
   if ((pin < MCP23017_PINCOUNT) && (value < 2)) {  // Check if values are in range
-    // Read the values from the device.
+    // Read the latch value from the device, unless the cache policy allows us to use the local copy.
     // bankMode can tell if address translation is needed or not.
-    regBank [MCP23017_REG_OLATA] = read (MCP23017_REG_OLATA, false);
-    regBank [MCP23017_REG_OLATB] = read (MCP23017_REG_OLATB, false);
+    if (cacheReadRequired()) {
+      regBank [MCP23017_REG_OLATA + (pin >> 3)] = read ((MCP23017_REG_OLATA + (pin >> 3)), false);
+    }
     
     uint8_t portValueByte = 0;
     
@@ -635,7 +1328,7 @@ uint8_t CSE_MCP23017:: digitalWrite (uint8_t pin, uint8_t value) {
       portValueByte = regBank [MCP23017_REG_OLATA + (pin >> 3)] & (~(0x1U << (pin & 0x7U))); // Write 0
     }
 
-    uint8_t response = write ((MCP23017_REG_OLATA + (pin >> 3)), portValueByte, false); // Write single byte
+    uint8_t response = writeRegister ((MCP23017_REG_OLATA + (pin >> 3)), portValueByte, false); // Write single byte
 
     if (response == MCP23017_RESP_OK) {
       regBank [MCP23017_REG_OLATA + (pin >> 3)] = portValueByte;
@@ -653,11 +1346,11 @@ uint8_t CSE_MCP23017:: digitalWrite (uint8_t pin, uint8_t value) {
 
 bool CSE_MCP23017:: printOperationStatus (bool input) {
   if (input == true) {
-    debugPort.println (F("Success"));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_BUS, F("Success"));
     return true;
   }
   else {
-    debugPort.println (F("Failed"));
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_BUS, F("Failed"));
     return false;
   }
 }
@@ -675,7 +1368,7 @@ uint8_t CSE_MCP23017:: portWrite (uint8_t port, uint8_t value) {
     uint8_t response = 0;
 
     // If value is 1, 0xFF will be written; o otherwise
-    response = write ((MCP23017_REG_OLATA + port), (value * 0xFF), false); // Write single byte
+    response = writeRegister ((MCP23017_REG_OLATA + port), (value * 0xFF), false); // Write single byte
 
     if (response == MCP23017_RESP_OK) {
        regBank [MCP23017_REG_OLATA + port] = (value * 0xFF);
@@ -696,12 +1389,15 @@ uint8_t CSE_MCP23017:: portWrite (uint8_t port, uint8_t value) {
  */
 uint8_t CSE_MCP23017:: togglePort (uint8_t port) {
   if (port < MCP23017_PORTCOUNT) {
-    // First read the device register
-    uint8_t portValue = read ((MCP23017_REG_OLATA + port), false);
-    portValue = ~(portValue); // Complement the byte
+    // First read the device register, if the cache policy requires it.
+    if (cacheReadRequired()) {
+      regBank [MCP23017_REG_OLATA + port] = read ((MCP23017_REG_OLATA + port), false);
+    }
+
+    uint8_t portValue = ~(regBank [MCP23017_REG_OLATA + port]); // Complement the byte
 
     // Only output latch register will be written
-    uint8_t response = write ((MCP23017_REG_OLATA + port), portValue, false);
+    uint8_t response = writeRegister ((MCP23017_REG_OLATA + port), portValue, false);
 
     // Save to the local register bank
     if (response == MCP23017_RESP_OK) {
@@ -722,14 +1418,16 @@ uint8_t CSE_MCP23017:: togglePort (uint8_t port) {
  */
 uint8_t CSE_MCP23017:: togglePin (uint8_t pin) {
   if (pin < MCP23017_PINCOUNT) {
-    // First read the device register.
-    uint8_t portValue = read ((MCP23017_REG_OLATA + (pin >> 3)), false);
+    // First read the device register, if the cache policy requires it.
+    if (cacheReadRequired()) {
+      regBank [MCP23017_REG_OLATA + (pin >> 3)] = read ((MCP23017_REG_OLATA + (pin >> 3)), false);
+    }
 
     // Now toggle a single bit.
     // XORing with 1 will cause the source bit to toggle.
-    portValue ^= (0x1U << (pin & 0x7U));
+    uint8_t portValue = regBank [MCP23017_REG_OLATA + (pin >> 3)] ^ (0x1U << (pin & 0x7U));
 
-    uint8_t response = write ((MCP23017_REG_OLATA + (pin >> 3)), portValue, false);
+    uint8_t response = writeRegister ((MCP23017_REG_OLATA + (pin >> 3)), portValue, false);
 
     // Save the value.
     if (response == MCP23017_RESP_OK) {
@@ -773,8 +1471,14 @@ uint8_t CSE_MCP23017:: readPinMode (uint8_t pin) {
     // Note : A 0 means Output for the IOE and 1 means Input.
     // Should check >0 since the bit can appear anywhere on the octet.
     // Example : 0b0010 0000
-    if (readPinBit (pin, MCP23017_REG_IODIRA) == 1) {  // If INPUT
-      if (readPinBit (pin, MCP23017_REG_GPPUA) == 1) {
+    // The configuration registers are only read from the device if the cache policy requires it.
+    if (cacheReadRequired()) {
+      readPinBit (pin, MCP23017_REG_IODIRA);
+      readPinBit (pin, MCP23017_REG_GPPUA);
+    }
+
+    if (((regBank [MCP23017_REG_IODIRA + (pin >> 3)] >> (pin & 0x7U)) & 0x1U) == 1) {  // If INPUT
+      if (((regBank [MCP23017_REG_GPPUA + (pin >> 3)] >> (pin & 0x7U)) & 0x1U) == 1) {
         return INPUT_PULLUP;
       }
       return INPUT;
@@ -802,6 +1506,8 @@ uint8_t CSE_MCP23017:: readPinBit (uint8_t pin, uint8_t reg, bool translate) {
     regBank [reg + (pin >> 3)] = read ((reg + (pin >> 3)), translate);
     return ((regBank [reg + (pin >> 3)] & (0x1U << (pin & 0x7U))) > 0) ? 1 : 0;
   }
+
+  return 0;
 }
 
 //============================================================================================//
@@ -834,9 +1540,10 @@ uint8_t CSE_MCP23017:: setPinInputPolarity (uint8_t pin, uint8_t value) {
   if ((pin < MCP23017_PINCOUNT) && (value < 2)) {
     uint8_t regValue = 0;  // A temp byte
 
-    //read registers
-    regBank [MCP23017_REG_IPOLA] = read (MCP23017_REG_IPOLA, false);
-    regBank [MCP23017_REG_IPOLB] = read (MCP23017_REG_IPOLB, false);
+    // Read the register, if the cache policy requires it.
+    if (cacheReadRequired()) {
+      regBank [MCP23017_REG_IPOLA + (pin >> 3)] = read ((MCP23017_REG_IPOLA + (pin >> 3)), false);
+    }
 
     if (value == 1) {  // Invert polarity
       regValue = regBank [MCP23017_REG_IPOLA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Write 1
@@ -845,7 +1552,7 @@ uint8_t CSE_MCP23017:: setPinInputPolarity (uint8_t pin, uint8_t value) {
       regValue = regBank [MCP23017_REG_IPOLA + (pin >> 3)] & (~(0x1U << (pin & 0x7U))); // Write 0
     }
 
-    uint8_t response = write ((MCP23017_REG_IPOLA + (pin >> 3)), regValue, false); // Write single byte
+    uint8_t response = writeRegister ((MCP23017_REG_IPOLA + (pin >> 3)), regValue, false); // Write single byte
 
     if (response == MCP23017_RESP_OK) {
       regBank [MCP23017_REG_IPOLA + (pin >> 3)] = regValue;
@@ -873,11 +1580,11 @@ uint8_t CSE_MCP23017:: setPortInputPolarity (uint8_t port, uint8_t value) {
 
     if (value == 1) {  // Invert polarity
       regValue = 0xFF;
-      response = write ((MCP23017_REG_IPOLA + port), 0xFF, false); // Write single byte
+      response = writeRegister ((MCP23017_REG_IPOLA + port), 0xFF, false); // Write single byte
     }
     else {  // No inversion
       regValue = 0;
-      response = write ((MCP23017_REG_IPOLA + port), 0x0, false); // Write single byte
+      response = writeRegister ((MCP23017_REG_IPOLA + port), 0x0, false); // Write single byte
     }
 
     if (response == MCP23017_RESP_OK) {
@@ -890,6 +1597,157 @@ uint8_t CSE_MCP23017:: setPortInputPolarity (uint8_t port, uint8_t value) {
   return MCP23017_ERROR_OOR;
 }
 
+//============================================================================================//
+/**
+ * @brief Reads both ports in a single transaction. Bits 0-7 are the pins of port A and bits
+ * 8-15 are the pins of port B. The values are also saved to the local register bank.
+ * You must check for `readError()` to know if an error occurred.
+ * 
+ * @return uint16_t The state of all 16 pins.
+ */
+uint16_t CSE_MCP23017:: readWord() {
+  readBurst (MCP23017_REG_GPIOA, regBank, MCP23017_REG_GPIOA, 2);
+  return uint16_t (regBank [MCP23017_REG_GPIOA]) | (uint16_t (regBank [MCP23017_REG_GPIOB]) << 8);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes to the output latches of both ports in a single transaction, so that all
+ * output pins change at the same time.
+ * 
+ * @param value The state of all 16 pins. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: writeWord (uint16_t value) {
+  return writeRegisterPair (MCP23017_REG_OLATA, value);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the IO direction and pull-ups of all 16 pins. Each register pair is written in a
+ * single transaction. To keep the API compatible with `pinMode()`, a 1 in `dirMask` sets the pin
+ * as OUTPUT, and a 0 sets it as INPUT. A 1 in `pullupMask` enables the pull-up of the pin.
+ * 
+ * @param dirMask The direction of all 16 pins. 1 = OUTPUT, 0 = INPUT.
+ * @param pullupMask The pull-up state of all 16 pins. 1 = Enabled, 0 = Disabled.
+ * @return uint8_t The I2C response code. Returns the largest of the error codes.
+ */
+uint8_t CSE_MCP23017:: modeWord (uint16_t dirMask, uint16_t pullupMask) {
+  // 1 means INPUT for the IOE.
+  uint8_t response_1 = writeRegisterPair (MCP23017_REG_IODIRA, uint16_t (~dirMask));
+  uint8_t response_2 = writeRegisterPair (MCP23017_REG_GPPUA, pullupMask);
+
+  return (response_1 > response_2) ? response_1 : response_2;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the input polarity of all 16 pins in a single transaction.
+ * 
+ * @param polarityMask The polarity of all 16 pins. 1 = Inverting, 0 = Non-inverting.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: polarityWord (uint16_t polarityMask) {
+  return writeRegisterPair (MCP23017_REG_IPOLA, polarityMask);
+}
+
+//============================================================================================//
+/**
+ * @brief Modifies the output latches of both ports. The new latch value is computed from the
+ * local register bank as `((latch & ~mask) | (value & mask)) ^ toggleMask`. Only the ports that
+ * have a bit set in `mask` or `toggleMask` are written. If both ports are touched, they are
+ * written in a single transaction. Otherwise, only a single byte is written.
+ * 
+ * @param mask The pins to assign from `value`.
+ * @param value The new state of the pins in `mask`.
+ * @param toggleMask The pins to toggle.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: modifyLatches (uint16_t mask, uint16_t value, uint16_t toggleMask) {
+  uint16_t touched = mask | toggleMask;
+
+  if (touched == 0) { // Nothing to do
+    return MCP23017_RESP_OK;
+  }
+
+  bool touchA = ((touched & 0x00FFU) != 0);
+  bool touchB = ((touched & 0xFF00U) != 0);
+
+  // Read the latches of the touched ports, if the cache policy requires it.
+  if (cacheReadRequired()) {
+    if (touchA && touchB) {
+      readBurst (MCP23017_REG_OLATA, regBank, MCP23017_REG_OLATA, 2);
+    }
+    else {
+      uint8_t port = touchB ? 1 : 0;
+      regBank [MCP23017_REG_OLATA + port] = read ((MCP23017_REG_OLATA + port), false);
+    }
+  }
+
+  uint16_t latch = uint16_t (regBank [MCP23017_REG_OLATA]) | (uint16_t (regBank [MCP23017_REG_OLATB]) << 8);
+  latch = ((latch & ~mask) | (value & mask)) ^ toggleMask;
+
+  if (touchA && touchB) {
+    return writeRegisterPair (MCP23017_REG_OLATA, latch);
+  }
+
+  uint8_t port = touchB ? 1 : 0;
+  uint8_t portValue = uint8_t (latch >> (8 * port));
+  uint8_t response = writeRegister ((MCP23017_REG_OLATA + port), portValue);
+
+  if (response == MCP23017_RESP_OK) {
+    regBank [MCP23017_REG_OLATA + port] = portValue;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a new state to an arbitrary set of pins without affecting the other pins.
+ * At most one write is made per port touched by `mask`.
+ * 
+ * @param mask The pins to write. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @param value The new state of the pins. Bits not in `mask` are ignored.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: writeMasked (uint16_t mask, uint16_t value) {
+  return modifyLatches (mask, value, 0);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets an arbitrary set of pins to HIGH.
+ * 
+ * @param mask The pins to set. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: setBits (uint16_t mask) {
+  return modifyLatches (mask, 0xFFFFU, 0);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets an arbitrary set of pins to LOW.
+ * 
+ * @param mask The pins to clear. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: clearBits (uint16_t mask) {
+  return modifyLatches (mask, 0, 0);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Toggles an arbitrary set of pins.
+ * 
+ * @param mask The pins to toggle. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: toggleBits (uint16_t mask) {
+  return modifyLatches (0, 0, mask);
+}
+
 //============================================================================================//
 /**
  * @brief Configures the output interrupt of the IO expander.
@@ -942,17 +1800,19 @@ uint8_t CSE_MCP23017:: configInterrupt (int8_t attachPin1, int8_t attachPin2, ui
     uint8_t regByte = 0;
     uint8_t response = 0;
 
-    debugPort.println (F("Configuring host interrupt"));
-    debugPort.println (F("Reading IOCON"));
-    regBank [MCP23017_REG_IOCON] = read (MCP23017_REG_IOCON, false);
-    debugPort.println (F("Success"));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Configuring host interrupt"));
+    if (cacheReadRequired()) {
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Reading IOCON"));
+      regBank [MCP23017_REG_IOCON] = read (MCP23017_REG_IOCON, false);
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
+    }
 
     //--------------------------------------------------------------------------------------------//
     // Set or reset open drain first.
     // Open-drain bit overrides the other two types.
 
     if (outType == MCP23017_OPENDRAIN) {
-      debugPort.println (F("Output type is Open Drain"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output type is Open Drain"));
       regByte = regBank [MCP23017_REG_IOCON] | (1U << MCP23017_BIT_ODR); // Write 1
     }
     else {
@@ -963,11 +1823,11 @@ uint8_t CSE_MCP23017:: configInterrupt (int8_t attachPin1, int8_t attachPin2, ui
     // Open-drain bit has to be 0 for these to work.
 
     if (outType == MCP23017_ACTIVE_LOW) {
-      debugPort.println (F("Output type is Active Low"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output type is Active Low"));
       regByte &= (~(1U << MCP23017_BIT_INTPOL));  // Write 0
     }
     else if (outType == MCP23017_ACTIVE_HIGH) {
-      debugPort.println (F("Output type is Active High"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output type is Active High"));
       regByte |= (1U << MCP23017_BIT_INTPOL); // Write 1
     }
 
@@ -975,7 +1835,7 @@ uint8_t CSE_MCP23017:: configInterrupt (int8_t attachPin1, int8_t attachPin2, ui
     // Reuse regByte since we need to keep previous modifications.
 
     if (mirror == MCP23017_INT_MIRROR) {
-      debugPort.println (F("Also mirror interrupt output"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Also mirror interrupt output"));
       regByte |= (1U << MCP23017_BIT_MIRROR); // Write 1
     }
     else {
@@ -984,24 +1844,25 @@ uint8_t CSE_MCP23017:: configInterrupt (int8_t attachPin1, int8_t attachPin2, ui
 
     //--------------------------------------------------------------------------------------------//
 
-    debugPort.println (F("Writing IOCON"));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing IOCON"));
     // Now write to device
     response = write (MCP23017_REG_IOCON, regByte, false); // Write single byte
-    debugPort.println (F("Success\n"));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success\n"));
 
     // Save to register bank
     if (response == MCP23017_RESP_OK) {
       regBank [MCP23017_REG_IOCON] = regByte;
+      regBank [MCP23017_REG_IOCON_] = regByte;  // Both addresses map to the same register
     }
 
     //--------------------------------------------------------------------------------------------//
     
     if (attachHostInterrupt() == MCP23017_RESP_OK) {
-      debugPort.println (F("Host MCU interrupt attach success\n"));
+      MCP23017_LOGLN_INFO (MCP23017_LOG_CONFIG, F("Host MCU interrupt attach success\n"));
       isIntConfigured = true;
     }
     else {
-      debugPort.println (F("Host MCU interrupt attach failed\n"));
+      MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("Host MCU interrupt attach failed\n"));
       isIntConfigured = false;
       return MCP23017_ERROR_OF; // Operation fail
     }
@@ -1025,14 +1886,60 @@ uint8_t CSE_MCP23017:: configInterrupt (int8_t attachPin1, int8_t attachPin2, ui
  * @return int MCP23017_RESP_OK or MCP23017_ERROR_WF.
  */
 int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode) {
+  int response = configPinInterrupt (pin, mode);
+
+  if (response == MCP23017_RESP_OK) {
+    isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
+    isrContextPtrList [pin] = NULL;
+    isrContextList [pin] = NULL;
+    isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Same as the other `attachInterrupt()`, but the ISR also receives a user context pointer.
+ * This allows a single function to serve multiple pins or objects.
+ * 
+ * @param pin The GPIO pin to attach the ISR to.
+ * @param isr An interupt service routine that accepts the pin and a context pointer.
+ * @param mode The mode of the interrupt input. Can be CHANGE (1), FALLING (2), RISING (3), LOW (4) or HIGH (5).
+ * @param context A pointer passed to the ISR as is.
+ * @return int MCP23017_RESP_OK or MCP23017_ERROR_WF.
+ */
+int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeContextCallback_t isr, uint8_t mode, void *context) {
+  int response = configPinInterrupt (pin, mode);
+
+  if (response == MCP23017_RESP_OK) {
+    isrPtrList [pin] = NULL;
+    isrContextPtrList [pin] = isr;
+    isrContextList [pin] = context;
+    isrModeList [pin] = mode;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Configures the interrupt-on-change registers of the IOE for a single pin. The ISR is
+ * saved by the caller.
+ * 
+ * @param pin The GPIO pin to configure.
+ * @param mode The mode of the interrupt input. Can be CHANGE (1), FALLING (2), RISING (3), LOW (4) or HIGH (5).
+ * @return int MCP23017_RESP_OK, MCP23017_ERROR_WF, MCP23017_ERROR_OF or MCP23017_ERROR_OOR.
+ */
+int CSE_MCP23017:: configPinInterrupt (uint8_t pin, uint8_t mode) {
   if ((pin < MCP23017_PINCOUNT) && (mode <= MCP23017_INTERRUPT_COUNT)) {
-    debugPort.print (F("Attaching interrupt to ioe pin "));
-    debugPort.println (pin);
+    MCP23017_LOG_DEBUG (MCP23017_LOG_CONFIG, F("Attaching interrupt to ioe pin "));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, pin);
 
     if (readPinMode (pin) == OUTPUT) {
-      debugPort.println (F("Pin is not configured as Input. Interrupts work only on Input pins.\n"));
-      debugPort.print (F("Pin mode is "));
-      debugPort.println (readPinMode (pin));
+      MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("Pin is not configured as Input. Interrupts work only on Input pins.\n"));
+      MCP23017_LOG_ERROR (MCP23017_LOG_CONFIG, F("Pin mode is "));
+      MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, readPinMode (pin));
       return MCP23017_ERROR_OF;
     }
 
@@ -1040,36 +1947,27 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       uint8_t regByte = 0;
       uint8_t response = 0;
 
-      // Read the registers.
-      debugPort.println (F("Reading registers"));
-      regBank [MCP23017_REG_IODIRA] = read (MCP23017_REG_GPINTENA, false); // Interrupt enable
-      regBank [MCP23017_REG_IODIRB] = read (MCP23017_REG_GPINTENB, false);
-
-      regBank [MCP23017_REG_GPINTENA] = read (MCP23017_REG_GPINTENA, false); 
-      regBank [MCP23017_REG_GPINTENB] = read (MCP23017_REG_GPINTENB, false);
-      
-      regBank [MCP23017_REG_DEFVALA] = read (MCP23017_REG_DEFVALA, false); // Default compare value
-      regBank [MCP23017_REG_DEFVALB] = read (MCP23017_REG_DEFVALB, false);
-      
-      regBank [MCP23017_REG_INTCONA] = read (MCP23017_REG_INTCONA, false); // Interrupt control
-      regBank [MCP23017_REG_INTCONB] = read (MCP23017_REG_INTCONB, false);
-      debugPort.println (F("Success"));
+      // Read the registers, if the cache policy requires it.
+      // Only the registers of the port the pin belongs to are needed.
+      if (cacheReadRequired()) {
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Reading registers"));
+        regBank [MCP23017_REG_GPINTENA + (pin >> 3)] = read ((MCP23017_REG_GPINTENA + (pin >> 3)), false); // Interrupt enable
+        regBank [MCP23017_REG_DEFVALA + (pin >> 3)] = read ((MCP23017_REG_DEFVALA + (pin >> 3)), false); // Default compare value
+        regBank [MCP23017_REG_INTCONA + (pin >> 3)] = read ((MCP23017_REG_INTCONA + (pin >> 3)), false); // Interrupt control
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
+      }
 
       //--------------------------------------------------------------------------------------------//
       // Needs to make INTCON bit 0, and the value in DEFVAL doesn't matter now.
       
       if (mode == MCP23017_INT_CHANGE) {
-        debugPort.println (F("Setting int mode to CHANGE"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting int mode to CHANGE"));
         regByte = regBank [MCP23017_REG_INTCONA + (pin >> 3)] & (~(0x1U << (pin & 0x7U))); // Set 0
-        response = write ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_INTCONA + (pin >> 3)] = regByte;  // If success, save the value
-
-          isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
-          isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
-          
           // return MCP23017_RESP_OK;
         }
         else {
@@ -1083,29 +1981,25 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       // If DEFVAL is 0, a 0 -> 1 (rising) transition will cause an interrupt.
       
       else if (mode == MCP23017_INT_RISING) {
-        debugPort.println (F("Setting int mode to RISING"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting int mode to RISING"));
         regByte = regBank [MCP23017_REG_INTCONA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Set 1
-        response = write ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_INTCONA + (pin >> 3)] = regByte;
         }
         else {
           return MCP23017_ERROR_WF;
         }
 
-        debugPort.println (F("Setting DEFVAL register"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting DEFVAL register"));
         regByte = regBank [MCP23017_REG_DEFVALA + (pin >> 3)] & (~(0x1U << (pin & 0x7U))); // Set 0
-        response = write ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_DEFVALA + (pin >> 3)] = regByte;
-          
-          isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
-          isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
-          
           // return MCP23017_RESP_OK;
         }
         else {
@@ -1119,30 +2013,26 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       // If DEFVAL is 1, a 1 -> 0 (falling) transition will cause an interrupt.
       
       else if (mode == MCP23017_INT_FALLING) {
-        debugPort.println (F("Setting int mode to FALLING"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting int mode to FALLING"));
         regByte = regBank [MCP23017_REG_INTCONA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Set 1
-        response = write ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_INTCONA + (pin >> 3)] = regByte;
         }
         else {
           return MCP23017_ERROR_WF;
         }
 
-        debugPort.println (F("Writing DEFVAL register."));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing DEFVAL register."));
         regByte = regBank [MCP23017_REG_DEFVALA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Wet 1
-        response = write ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_DEFVALA + (pin >> 3)] = regByte;
-          
-          isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
-          isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
-          
-          debugPort.println (F("Interrupt configured for FALLING"));
+          MCP23017_LOGLN_INFO (MCP23017_LOG_CONFIG, F("Interrupt configured for FALLING"));
           // return MCP23017_RESP_OK;
         }
         else {
@@ -1155,29 +2045,25 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       // State checking is same as falling edge interrupt.
       
       else if (mode == MCP23017_INT_LOW) {
-        debugPort.println (F("Setting int mode to LOW"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting int mode to LOW"));
         regByte = regBank [MCP23017_REG_INTCONA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Set 1
-        response = write ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_INTCONA + (pin >> 3)] = regByte;
         }
         else {
           return MCP23017_ERROR_WF; // Write failure
         }
 
-        debugPort.println (F("Writing DEFVAL register."));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing DEFVAL register."));
         regByte = regBank [MCP23017_REG_DEFVALA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Wet 1
-        response = write ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_DEFVALA + (pin >> 3)] = regByte;
-          
-          isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
-          isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
-          
           // return MCP23017_RESP_OK;
         }
         else {
@@ -1190,29 +2076,25 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       // State checking is same as rising edge interrupt.
       
       else if (mode == MCP23017_INT_HIGH) {
-        debugPort.println (F("Setting int mode to HIGH"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Setting int mode to HIGH"));
         regByte = regBank [MCP23017_REG_INTCONA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Set 1
-        response = write ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_INTCONA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_INTCONA + (pin >> 3)] = regByte;
         }
         else {
           return MCP23017_ERROR_WF;
         }
 
-        debugPort.println (F("Writing DEFVAL register."));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Writing DEFVAL register."));
         regByte = regBank [MCP23017_REG_DEFVALA + (pin >> 3)] & (~(0x1U << (pin & 0x7U))); // Set 0
-        response = write ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
+        response = writeRegister ((MCP23017_REG_DEFVALA + (pin >> 3)), regByte, false); // Write single byte
 
         if (response == MCP23017_RESP_OK) {
-          debugPort.println (F("Success"));
+          MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success"));
           regBank [MCP23017_REG_DEFVALA + (pin >> 3)] = regByte;
-          
-          isrPtrList [pin] = isr; // Save the isr for that isrSupervisor can call this function
-          isrModeList [pin] = mode; // Save the interrupt mode for each pins so that isrSupervisor can check if the conditions are met
-          
           // return MCP23017_RESP_OK;
         }
         else {
@@ -1224,19 +2106,20 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
       // Invalid mode.
 
       else {
-        debugPort.println (F("MCP23017 : Wrong interrupt mode (0). Failed to attach interrupt."));
+        MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("MCP23017 : Wrong interrupt mode (0). Failed to attach interrupt."));
+        return MCP23017_ERROR_OOR;
       }
 
       //--------------------------------------------------------------------------------------------//
 
-      debugPort.println (F("Enabling Interrupt on Change"));
+      MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Enabling Interrupt on Change"));
       // Set GPINTEN to 1 enable the interrupt on change for each pin.
       regByte = regBank [MCP23017_REG_GPINTENA + (pin >> 3)] | (0x1U << (pin & 0x7U));  // Set 1
-      response = write ((MCP23017_REG_GPINTENA + (pin >> 3)), regByte, false); // Write single byte
+      response = writeRegister ((MCP23017_REG_GPINTENA + (pin >> 3)), regByte, false); // Write single byte
 
       // Save the value.
       if (response == MCP23017_RESP_OK) {
-        debugPort.println (F("Success\n"));
+        MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Success\n"));
         regBank [MCP23017_REG_GPINTENA + (pin >> 3)] = regByte;
         return MCP23017_RESP_OK;
       }
@@ -1244,8 +2127,12 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
         return MCP23017_ERROR_WF;
       }
     }
+    else if (pollingEnabled) {
+      // The interrupt registers of the IOE are not used by pollChanges().
+      return MCP23017_RESP_OK;
+    }
     else {
-      debugPort.println (F("MCP23017 : Interrupt is not configured. Use configInterrupt() to configure.\n"));
+      MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("MCP23017 : Interrupt is not configured. Use configInterrupt() or setPolling() to configure.\n"));
     }
   }
 
@@ -1257,209 +2144,662 @@ int CSE_MCP23017:: attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode
 //use configInterrupt to configure the pins and type
 /**
  * @brief Attachs the host MCU interrupt to detect the outputs from the IO expander.
- * Use `configInterrupt()` to configure the pins and type.
+ * Use `configInterrupt()` to configure the pins and type. Any lines attached earlier are
+ * released first.
  * 
  * @return uint8_t The status.
  */
 uint8_t CSE_MCP23017:: attachHostInterrupt() {
-  debugPort.println (F("Attaching host MCU interrupt"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Attaching host MCU interrupt"));
+
+  if (ioeIndex == MCP23017_INDEX_NONE) {
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("MCP23017 Error : Object is not registered."));
+    return MCP23017_ERROR_OF;
+  }
+
+  uint8_t mode;
+
   // Active-Low means the signal will be a falling edge.
   if (intOutType == MCP23017_ACTIVE_LOW) {
-    debugPort.println (F("Output is Active Low"));
-    if (attachPinA != -1) {
-      debugPort.println (F("Attaching ISR to pin A"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      delay (100);
-      ::attachInterrupt (attachPinA, hostCallbackList [ioeIndex], FALLING);
-      debugPort.println (F("Success"));
-    }
-
-    if (attachPinB != -1) { // B could be negative
-      debugPort.println (F("Attaching ISR to pin B"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      delay (100);
-      ::attachInterrupt (attachPinB, hostCallbackList [ioeIndex], FALLING);
-      debugPort.println (F("Success"));
-    }
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output is Active Low"));
+    mode = FALLING;
   }
 
   // Active-High means the signal will be a rising edge.
   else if (intOutType == MCP23017_ACTIVE_HIGH) {
-    debugPort.println (F("Output is Active High"));
-    if (attachPinA != -1) {
-      debugPort.println (F("Attaching ISR to pin A"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      ::attachInterrupt (attachPinA, hostCallbackList [ioeIndex], RISING);
-      debugPort.println (F("Success"));
-    }
-
-    if (attachPinB != -1) { // B could be negative
-      debugPort.println (F("Attaching ISR to pin B"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      ::attachInterrupt (attachPinB, hostCallbackList [ioeIndex], RISING);
-      debugPort.println (F("Success"));
-    }
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output is Active High"));
+    mode = RISING;
   }
 
   // Open-Drain means the interrupt output from the IOE will be either LOW or High-Z.
   // If you choose Opne-Drain, you have to either use the  internal pull-up of the host MCU
   // or add an external pull-up. That means the circuit will be equivalent to that of falling edge detection.
   else if (intOutType == MCP23017_OPENDRAIN) {
-    debugPort.println (F("Output is Open Drain"));
-    if (attachPinA != -1) {
-      debugPort.println (F("Attaching ISR to pin A"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      ::attachInterrupt (attachPinA, hostCallbackList [ioeIndex], FALLING);
-      debugPort.println (F("Success"));
-    }
-
-    if (attachPinB != -1) { // B could be negative
-      debugPort.println (F("Attaching ISR to pin B"));
-      debugPort.print (F("ioeId is "));
-      debugPort.println (ioeIndex);
-      ::attachInterrupt (attachPinB, hostCallbackList [ioeIndex], FALLING);
-      debugPort.println (F("Success"));
-    }
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Output is Open Drain"));
+    mode = FALLING;
   }
 
   else {
-    debugPort.print (F("Failed\n"));
+    MCP23017_LOG_ERROR (MCP23017_LOG_CONFIG, F("Failed\n"));
     return MCP23017_ERROR_OOR;
   }
 
-  debugPort.println();
+  releaseHostLines();
 
-  return MCP23017_RESP_OK;
+  uint8_t response = MCP23017_RESP_OK;
+
+  if (attachPinA != -1) {
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Attaching ISR to pin A"));
+    response = attachHostLine (MCP23017_PORT_A, attachPinA, mode);
+  }
+
+  if ((attachPinB != -1) && (attachPinB != attachPinA) && (response == MCP23017_RESP_OK)) { // B could be negative
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Attaching ISR to pin B"));
+    response = attachHostLine (MCP23017_PORT_B, attachPinB, mode);
+  }
+
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F(""));
+
+  return response;
 }
 
-//============================================================================================//
+//--------------------------------------------------------------------------------------------//
 /**
- * @brief Processes an interrupt from the IO expander.
+ * @brief Attaches an interrupt line of the object to a host pin. If a line of another object is
+ * already attached to the pin, this line is chained to it and the host interrupt is not attached
+ * again. Objects sharing a pin must use the same interrupt output type.
  * 
+ * @param port The line to attach. `MCP23017_PORT_A` or `MCP23017_PORT_B`.
+ * @param pin The host MCU pin.
+ * @param mode The host interrupt mode. `FALLING` or `RISING`.
+ * @return uint8_t `MCP23017_RESP_OK` or `MCP23017_ERROR_PAE` if the pin is shared with a different mode.
  */
-void CSE_MCP23017:: dispatchInterrupt() {
-  if ((interruptActive == true) && (stateReverted == true)) {
-    isrSupervisor();
-    interruptActive = false;
-    debugPort.println (F("Interrupt flag has been reset\n"));
-    delay (100);
-    regBank [MCP23017_REG_INTCAPA] = read (MCP23017_REG_INTCAPA, false);
-    regBank [MCP23017_REG_INTCAPB] = read (MCP23017_REG_INTCAPB, false);
-    stateReverted = false;
-  }
-
-  else if (stateReverted == false) {
-    if (lastIntPin >= 0) {
-      if (isrModeList [lastIntPin] == MCP23017_INT_FALLING) {
-        if (readPinBit (lastIntPin, MCP23017_REG_GPIOA) == MCP23017_HIGH) {
-          stateReverted = true;
-        }
-      }
-      else if (isrModeList [lastIntPin] == MCP23017_INT_RISING) {
-        if (readPinBit (lastIntPin, MCP23017_REG_GPIOA) == MCP23017_LOW) {
-          stateReverted = true;
-        }
-      }
+uint8_t CSE_MCP23017:: attachHostLine (uint8_t port, int8_t pin, uint8_t mode) {
+  uint8_t line = (ioeIndex << 1) + port;
+
+  for (uint8_t head = 0; head < MCP23017_LINE_COUNT; head++) {
+    if ((ioeList [head >> 1] == nullptr) || (!ioeLineHead [head]) || (ioeLinePin [head] != pin)) {
+      continue;
     }
-  }
-}
 
-//============================================================================================//
+    if (ioeLineMode [head] != mode) {
+      MCP23017_LOGLN_ERROR (MCP23017_LOG_CONFIG, F("MCP23017 Error : Shared host pin has a different interrupt mode."));
+      return MCP23017_ERROR_PAE;
+    }
 
-bool CSE_MCP23017:: interruptPending() {
-  return interruptActive;
+    // Chain the line after the head. The head handler may run at any time, so the chain must
+    // stay valid at every step.
+    noInterrupts();
+    ioeLinePin [line] = pin;
+    ioeLineNext [line] = ioeLineNext [head];
+    ioeLineNext [head] = line;
+    interrupts();
+
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_CONFIG, F("Sharing the host pin"));
+    return MCP23017_RESP_OK;
+  }
+
+  ioeLinePin [line] = pin;
+  ioeLineMode [line] = mode;
+  ioeLineNext [line] = MCP23017_LINE_NONE;
+  ioeLineHead [line] = true;
+  ::attachInterrupt (pin, hostCallbackList:: list [line], mode);
+
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Releases both interrupt lines of the object. If a line is the head of a shared host pin,
+ * the host interrupt is handed over to the next line in the chain. Otherwise, the host interrupt
+ * is detached.
+ * 
+ */
+void CSE_MCP23017:: releaseHostLines() {
+  for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+    uint8_t line = (ioeIndex << 1) + port;
+
+    if (ioeLinePin [line] == -1) {
+      continue;
+    }
+
+    if (ioeLineHead [line]) {
+      uint8_t next = ioeLineNext [line];
+
+      if (next != MCP23017_LINE_NONE) {
+        ioeLineHead [next] = true;
+        ioeLineMode [next] = ioeLineMode [line];
+        ::attachInterrupt (ioeLinePin [line], hostCallbackList:: list [next], ioeLineMode [line]);  // Replaces the handler
+      }
+      else {
+        ::detachInterrupt (ioeLinePin [line]);  // Arduino-API
+      }
+    }
+    else {
+      for (uint8_t prev = 0; prev < MCP23017_LINE_COUNT; prev++) {
+        if ((ioeList [prev >> 1] != nullptr) && (ioeLineNext [prev] == line)) {
+          noInterrupts();
+          ioeLineNext [prev] = ioeLineNext [line];
+          interrupts();
+          break;
+        }
+      }
+    }
+
+    ioeLinePin [line] = -1;
+    ioeLineHead [line] = false;
+    ioeLineNext [line] = MCP23017_LINE_NONE;
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Signals a host interrupt to the object. Called by the host interrupt handlers, in
+ * interrupt context. If the event queue is enabled for the object, the edge is queued with its
+ * timestamp, so bursts of edges are not lost. Otherwise, the interrupt is flagged for
+ * `dispatchInterrupt()`. Edges arriving while the flag is set are merged into it.
+ * 
+ * @param timestamp Host `micros()` at the time of the interrupt.
+ */
+void CSE_MCP23017:: signalInterrupt (uint32_t timestamp) {
+#ifdef MCP23017_ENABLE_STATS
+  stats.interruptsReceived++;
+#endif
+
+  if (eventQueueEnabled) {
+    ioeEvent_t event;
+    event.timestamp = timestamp;
+    event.device = ioeIndex;
+    event.pin = -1;
+    event.flags = 0;
+    event.capture = 0;
+    event.gpio = 0;
+    event.serviced = false;
+
+    if (!ioeEventQueue.push (event)) {
+#ifdef MCP23017_ENABLE_STATS
+      stats.interruptsDropped++;
+#endif
+    }
+    return;
+  }
+
+#ifdef MCP23017_ENABLE_STATS
+  if (interruptActive) {
+    stats.interruptsDropped++;  // Merged into the pending interrupt
+  }
+#endif
+
+  // Activate the interrupt so that next time the ISR dispatcher is called
+  // the ISR will be executed.
+  interruptTime = timestamp;
+  interruptActive = true;
 }
 
 //============================================================================================//
 /**
- * @brief This is the supervisor function that manages all user ISRs. When an interrupt is registered
- * by the host MCU, the `isrSupervisor()` should determine which pin of the IOE caused it and invoke the
- * associated ISR set by the user. This requires disabling the host MCU interrupt first and then reading
- * the IOE registers INTF, GPINTEN, DEFVAL, INTCON, and INTCAP in order. Then determine which pin caused
- * the interrupt, verify the interrupt attached to the pin, and call the ISR.
- * On return, re-attach the host MCU interrupt.
+ * @brief Processes an interrupt from the IO expander. This must be called from the main loop.
+ * The function never blocks. If no interrupt is pending and no pin is waiting to be re-armed,
+ * it returns immediately without any I2C transactions.
+ * 
+ * After a pin is serviced, the pin is held off for the time set by `setInterruptTiming()`.
+ * Edge (`MCP23017_INT_FALLING`, `MCP23017_INT_RISING`) and level (`MCP23017_INT_LOW`,
+ * `MCP23017_INT_HIGH`) interrupts use the compare mode of the IOE, which keeps asserting the
+ * interrupt as long as the pin is in the active state. So these pins are disarmed (`GPINTEN`
+ * cleared) after service, and re-armed here once the holdoff has expired. Edge interrupts also
+ * wait until the pin has returned to the inactive state, which is checked every re-arm interval.
+ * Level interrupts are re-armed right after the holdoff, so the ISR is called again at the
+ * holdoff rate while the level persists.
  * 
  */
-void CSE_MCP23017:: isrSupervisor() {
-  if (isIntConfigured == true) { // Not necessary though
-    // Detach the host MCU interrupts.
-    if (attachPinA != -1) {
-      ::detachInterrupt (attachPinA); // Arduino-API
+void CSE_MCP23017:: dispatchInterrupt() {
+  if (interruptActive == true) {
+    // Clear the flag first so that an interrupt arriving during the service is not lost.
+    interruptActive = false;
+    uint32_t startTime = micros();
+    isrSupervisor();
+    recordService (startTime);
+  }
+
+  if (disarmedMask != 0) {
+    rearmPins();
+  }
+
+  // If the interrupt output is still asserted, another event is already waiting.
+  if (hostInterruptAsserted()) {
+    interruptActive = true;
+  }
+
+  stateReverted = (disarmedMask == 0);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Re-arms the disarmed pins whose holdoff has expired. Edge interrupts are only re-armed
+ * once the pin has returned to the inactive state. The registers are read only if at least one
+ * edge pin is due for a check, and `GPINTEN` is written only if at least one pin is re-armed.
+ * 
+ * The check reads `INTF` to `GPIO` in a single burst, because reading `GPIO` alone would clear
+ * the flags latched since the last service. The armed pins flagged in the burst are serviced
+ * first, and the levels are then taken from the `GPIO` bytes of the same burst.
+ * 
+ */
+void CSE_MCP23017:: rearmPins() {
+  uint32_t now = millis();
+  uint16_t duePins = 0;
+  uint16_t checkPins = 0;
+  uint16_t pending = disarmedMask;
+
+  while (pending != 0) {
+    uint8_t pin = uint8_t (__builtin_ctz (pending));
+    pending &= (pending - 1);
+
+    if ((now - pinEventTime [pin]) < pinHoldoff (pin)) {
+      continue;
     }
-    
-    if (attachPinB != -1) {
-      ::detachInterrupt (attachPinB);
+
+    if ((isrModeList [pin] == MCP23017_INT_FALLING) || (isrModeList [pin] == MCP23017_INT_RISING)) {
+      if ((now - pinCheckTime [pin]) >= rearmList [pin]) {
+        checkPins |= (1U << pin);
+      }
+    }
+    else {
+      duePins |= (1U << pin);
     }
-    // debugPort.println (F("Detaching host interrupts"));
   }
 
-  //--------------------------------------------------------------------------------------------//
-  // Read the registers.
+  if (checkPins != 0) {
+    if (readBurst (MCP23017_REG_INTFA, regBank, MCP23017_REG_INTFA, 6) == MCP23017_RESP_OK) {
+      uint16_t gpio = uint16_t (regBank [MCP23017_REG_GPIOA]) | (uint16_t (regBank [MCP23017_REG_GPIOB]) << 8);
+      uint16_t armedPins = (uint16_t (regBank [MCP23017_REG_GPINTENA]) | (uint16_t (regBank [MCP23017_REG_GPINTENB]) << 8)) & ~disarmedMask;
+      uint16_t intFlags = (uint16_t (regBank [MCP23017_REG_INTFA]) | (uint16_t (regBank [MCP23017_REG_INTFB]) << 8)) & armedPins;
+      uint16_t intCaptures = uint16_t (regBank [MCP23017_REG_INTCAPA]) | (uint16_t (regBank [MCP23017_REG_INTCAPB]) << 8);
+
+      serviceFlags (intFlags, intCaptures);
+
+      while (checkPins != 0) {
+        uint8_t pin = uint8_t (__builtin_ctz (checkPins));
+        checkPins &= (checkPins - 1);
+        pinCheckTime [pin] = now;
+
+        // Falling edge pins are inactive when HIGH, and rising edge pins when LOW.
+        if (((gpio >> pin) & 0x1U) == ((isrModeList [pin] == MCP23017_INT_FALLING) ? 1U : 0U)) {
+          duePins |= (1U << pin);
+        }
+      }
+    }
+  }
+
+  if (duePins != 0) {
+    if (setInterruptEnable (duePins, true) == MCP23017_RESP_OK) {
+      disarmedMask &= ~duePins;
+    }
+  }
+}
 
-  // The interrupt flag determines which pin caused the interrupt.
-  // This has to be read before disabling the IOE interrupts.
-  regBank [MCP23017_REG_INTFA] = read (MCP23017_REG_INTFA, false);
-  regBank [MCP23017_REG_INTFB] = read (MCP23017_REG_INTFB, false);
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets or clears the `GPINTEN` bits of a set of pins. Each port is written only if it
+ * has a pin in the mask.
+ * 
+ * @param mask The pins to modify. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @param enable `true` to enable the interrupt, `false` to disable.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: setInterruptEnable (uint16_t mask, bool enable) {
+  uint8_t response = MCP23017_RESP_OK;
 
-  regBank [MCP23017_REG_GPINTENA] = read (MCP23017_REG_GPINTENA, false); // Interrupt enable
-  regBank [MCP23017_REG_GPINTENB] = read (MCP23017_REG_GPINTENB, false);
+  for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+    uint8_t portMask = uint8_t (mask >> (8 * port));
 
-  write (MCP23017_REG_GPINTENA, 0);
-  write (MCP23017_REG_GPINTENB, 0);
+    if (portMask == 0) {
+      continue;
+    }
 
-  // regBank [MCP23017_REG_INTCONA] = read (MCP23017_REG_INTCONA, false); // IOC control
-  // regBank [MCP23017_REG_INTCONB] = read (MCP23017_REG_INTCONB, false);
+    uint8_t regByte = enable ? (regBank [MCP23017_REG_GPINTENA + port] | portMask) : (regBank [MCP23017_REG_GPINTENA + port] & (~portMask));
+    uint8_t status = writeRegister ((MCP23017_REG_GPINTENA + port), regByte);
 
-  // write (MCP23017_REG_INTCONA, 0);
-  // write (MCP23017_REG_INTCONB, 0);
+    if (status == MCP23017_RESP_OK) {
+      regBank [MCP23017_REG_GPINTENA + port] = regByte;
+    }
 
-  debugPort.println (F("ISR Supervisor invoked"));
-  debugPort.println (F("Disabling IOE interrupts"));
+    response = (status > response) ? status : response;
+  }
 
-  if ((!readError()) || (!writeError())) {
-    debugPort.println (F("Success"));
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Checks the interrupt attach pins of the host MCU for an asserted interrupt output.
+ * No I2C transactions are made.
+ * 
+ * @return true At least one interrupt output of the IOE is in the active state.
+ * @return false No interrupt output is active, or interrupts are not configured.
+ */
+bool CSE_MCP23017:: hostInterruptAsserted() {
+  if (!isIntConfigured) {
+    return false;
+  }
+
+  uint8_t activeState = (intOutType == MCP23017_ACTIVE_HIGH) ? HIGH : LOW;
+
+  if ((attachPinA != -1) && (::digitalRead (attachPinA) == activeState)) {
+    return true;
+  }
+
+  if ((attachPinB != -1) && (::digitalRead (attachPinB) == activeState)) {
+    return true;
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the interrupt timing of a single pin. The holdoff is the minimum time between two
+ * services of the pin, and is used for debouncing. Events on the pin during the holdoff are
+ * ignored. The re-arm interval is how often an edge interrupt pin is checked for returning to
+ * the inactive state after the holdoff.
+ * 
+ * By default (`MCP23017_INT_HOLDOFF_AUTO`), the holdoff follows the interrupt mode. Level pins
+ * get `MCP23017_INT_HOLDOFF_MS`, which limits the rate of the ISR calls while the level persists.
+ * Edge pins get `MCP23017_INT_EDGE_HOLDOFF_MS` (0), so edges closer together than the level
+ * holdoff are not dropped. Set a holdoff here to debounce an edge pin.
+ * 
+ * @param pin The pin to configure. Can be 0-15.
+ * @param holdoff The holdoff time in milliseconds, or `MCP23017_INT_HOLDOFF_AUTO`.
+ * @param rearm The re-arm check interval in milliseconds.
+ * @return uint8_t `MCP23017_RESP_OK` or `MCP23017_ERROR_OOR`.
+ */
+uint8_t CSE_MCP23017:: setInterruptTiming (uint8_t pin, uint16_t holdoff, uint16_t rearm) {
+  if (pin < MCP23017_PINCOUNT) {
+    holdoffList [pin] = holdoff;
+    rearmList [pin] = rearm;
+    return MCP23017_RESP_OK;
+  }
+
+  return MCP23017_ERROR_OOR;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the holdoff time of a pin, resolving `MCP23017_INT_HOLDOFF_AUTO` by the
+ * interrupt mode of the pin.
+ * 
+ * @param pin The pin. Can be 0-15.
+ * @return uint16_t The holdoff time in milliseconds.
+ */
+uint16_t CSE_MCP23017:: pinHoldoff (uint8_t pin) {
+  if (holdoffList [pin] != MCP23017_INT_HOLDOFF_AUTO) {
+    return holdoffList [pin];
+  }
+
+  if ((isrModeList [pin] == MCP23017_INT_LOW) || (isrModeList [pin] == MCP23017_INT_HIGH)) {
+    return MCP23017_INT_HOLDOFF_MS;
+  }
+
+  return MCP23017_INT_EDGE_HOLDOFF_MS;
+}
+
+//============================================================================================//
+/**
+ * @brief Enables calling the attached ISRs by polling, for boards where the interrupt outputs
+ * of the IOE are not connected to the host. `attachInterrupt()` then only saves the ISR, without
+ * configuring the interrupt registers of the IOE. Call `pollChanges()` from the main loop.
+ * 
+ * The poll interval adapts to the activity of the inputs. It drops to `floor` when an input
+ * changes or an ISR is called, and doubles after every idle poll, up to `ceiling`.
+ * 
+ * @param enable `true` to enable polling, `false` to disable.
+ * @param floor The shortest poll interval in milliseconds. 0 polls on every call.
+ * @param ceiling The longest poll interval in milliseconds. Must not be less than `floor`.
+ * @return uint8_t `MCP23017_RESP_OK`, the I2C response code, or `MCP23017_ERROR_OOR`.
+ */
+uint8_t CSE_MCP23017:: setPolling (bool enable, uint16_t floor, uint16_t ceiling) {
+  if (ceiling < floor) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  pollFloor = floor;
+  pollCeiling = ceiling;
+  pollInterval = floor;
+  pollingEnabled = enable;
+
+  if (!enable) {
+    return MCP23017_RESP_OK;
+  }
+
+  // Take the current state as the reference, so that the first poll does not report changes.
+  uint8_t response = readBurst (MCP23017_REG_GPIOA, regBank, MCP23017_REG_GPIOA, 2);
+  pollState = uint16_t (regBank [MCP23017_REG_GPIOA]) | (uint16_t (regBank [MCP23017_REG_GPIOB]) << 8);
+  pollTime = millis();
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads both GPIO registers in a single transaction if the poll interval has elapsed,
+ * and calls the ISRs of the pins that meet their interrupt mode. Edge and change modes are
+ * called when the pin changed since the last poll. Level modes are called on every poll while
+ * the level persists, at most once per holdoff time. Edge modes have no holdoff by default, so
+ * every change seen by a poll is served. A holdoff set by `setInterruptTiming()` also applies to
+ * the edge modes, which filters out bounces.
+ * 
+ * The previous state is kept by the poller, so other reads of the GPIO registers do not hide
+ * the changes.
+ * 
+ * @return uint16_t The input pins that changed since the last poll. Bits 0-7 = Port A, bits
+ * 8-15 = Port B. 0 if nothing changed, the interval has not elapsed, or the read failed.
+ */
+uint16_t CSE_MCP23017:: pollChanges() {
+  if ((!pollingEnabled) || ((millis() - pollTime) < pollInterval)) {
+    return 0;
+  }
+
+  pollTime = millis();
+  interruptTime = micros();
+
+  if (readBurst (MCP23017_REG_GPIOA, regBank, MCP23017_REG_GPIOA, 2) != MCP23017_RESP_OK) {
+    return 0;
+  }
+
+  uint16_t state = uint16_t (regBank [MCP23017_REG_GPIOA]) | (uint16_t (regBank [MCP23017_REG_GPIOB]) << 8);
+  uint16_t inputs = uint16_t (regBank [MCP23017_REG_IODIRA]) | (uint16_t (regBank [MCP23017_REG_IODIRB]) << 8);
+  uint16_t changed = (state ^ pollState) & inputs;
+  pollState = state;
+
+  // Pins whose ISR should be considered: any changed pin, and the level pins in their level.
+  uint16_t candidates = 0;
+
+  for (uint8_t pin = 0; pin < MCP23017_PINCOUNT; pin++) {
+    uint8_t level = (state >> pin) & 0x1U;
+
+    if (((isrModeList [pin] == MCP23017_INT_LOW) && (level == 0)) || ((isrModeList [pin] == MCP23017_INT_HIGH) && (level == 1))) {
+      candidates |= (1U << pin);
+    }
+    else if ((isrModeList [pin] != 0) && (changed & (1U << pin))) {
+      candidates |= (1U << pin);
+    }
+  }
+
+  candidates &= inputs;
+  bool served = false;
+
+  while (candidates != 0) {
+    uint8_t pin = uint8_t (__builtin_ctz (candidates));
+    candidates &= (candidates - 1);
+    served |= servicePin (pin, ((state >> pin) & 0x1U));
+  }
+
+  // Poll fast while the inputs are active, and back off when they are idle.
+  if ((changed != 0) || served) {
+    pollInterval = pollFloor;
   }
   else {
-    debugPort.println (F("Failed"));
+    uint32_t next = (pollInterval == 0) ? 1 : (uint32_t (pollInterval) << 1);
+    pollInterval = uint16_t ((next > pollCeiling) ? pollCeiling : next);
   }
 
-  debugPort.println (F("Reading registers"));
-  
-  // regBank [MCP23017_REG_DEFVALA] = read (MCP23017_REG_DEFVALA, false); // Default compare value
-  // regBank [MCP23017_REG_DEFVALB] = read (MCP23017_REG_DEFVALB, false);
+  return changed;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the current poll interval of `pollChanges()`.
+ * 
+ * @return uint16_t The interval in milliseconds.
+ */
+uint16_t CSE_MCP23017:: getPollInterval() {
+  return pollInterval;
+}
+
+//============================================================================================//
+
+bool CSE_MCP23017:: interruptPending() {
+  return interruptActive;
+}
 
-  regBank [MCP23017_REG_INTCAPA] = read (MCP23017_REG_INTCAPA, false); // Interrupt capture
-  regBank [MCP23017_REG_INTCAPB] = read (MCP23017_REG_INTCAPB, false);
+//============================================================================================//
+/**
+ * @brief Sets whether `isrSupervisor()` should also read the GPIO registers in the same burst as
+ * the interrupt flag and capture registers. This costs two more bytes per interrupt, but keeps
+ * the GPIO values in the local register bank up to date with the state after the interrupt.
+ * 
+ * @param enable `true` to read the GPIO registers, `false` to only read INTF and INTCAP.
+ */
+void CSE_MCP23017:: setServiceGpioRead (bool enable) {
+  isrReadGpio = enable;
+}
 
-  if (!readError()) {
-    debugPort.println (F("Success"));
+//============================================================================================//
+/**
+ * @brief Enables or disables the event queue for this object. When enabled, each host interrupt
+ * is added to the shared event queue with a timestamp, and must be collected with `pollEvents()`
+ * instead of `dispatchInterrupt()`. The user ISRs are not called in this mode.
+ * 
+ * The compare mode interrupts (`MCP23017_INT_FALLING`, `MCP23017_INT_RISING`, `MCP23017_INT_LOW`
+ * and `MCP23017_INT_HIGH`) keep asserting the interrupt while the pin is active, so use
+ * `MCP23017_INT_CHANGE` with the event queue.
+ * 
+ * @param enable `true` to queue the events, `false` to dispatch them.
+ */
+void CSE_MCP23017:: setEventQueue (bool enable) {
+  eventQueueEnabled = enable;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns whether the event queue is enabled for this object.
+ * 
+ * @return true Events are queued for `pollEvents()`.
+ * @return false Events are dispatched by `dispatchInterrupt()`.
+ */
+bool CSE_MCP23017:: eventQueueActive() {
+  return eventQueueEnabled;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Collects the oldest event from the shared event queue. The registers of the event are
+ * read from the device that raised it, before it is returned. The event keeps the timestamp of
+ * the host interrupt. Call this repeatedly from the main loop until it returns `false`.
+ * 
+ * If several edges arrived before the event was serviced, `INTCAP` holds the state at the first
+ * edge and `GPIO` the state at the time of service. Later events of the same burst may find no
+ * flagged pins (`pin` is -1), but still carry their own timestamp and `GPIO` value.
+ * 
+ * @param event The event is copied here.
+ * @return true An event was returned.
+ * @return false The queue is empty.
+ */
+bool CSE_MCP23017:: pollEvents (ioeEvent_t &event) {
+  ioeEvent_t *slot = ioeEventQueue.peek();
+
+  if (slot == nullptr) {
+    return false;
+  }
+
+  if ((!slot->serviced) && (slot->device < MCP23017_MAX_OBJECT) && (ioeList [slot->device] != nullptr)) {
+    uint32_t startTime = micros();
+    ioeList [slot->device]->serviceEvent (*slot);
+    ioeList [slot->device]->recordService (startTime);
+    ioeList [slot->device]->recordLatency (slot->timestamp);
+  }
+
+  return ioeEventQueue.pop (event);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads `INTF`, `INTCAP` and `GPIO` of both ports in a single burst and saves them to the
+ * event. Reading `INTCAP` clears the interrupt.
+ * 
+ * @param event The event to fill.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: serviceEvent (ioeEvent_t &event) {
+  uint8_t response = readBurst (MCP23017_REG_INTFA, regBank, MCP23017_REG_INTFA, (MCP23017_REG_GPIOB - MCP23017_REG_INTFA + 1));
+
+  if (response == MCP23017_RESP_OK) {
+    event.flags = uint16_t (regBank [MCP23017_REG_INTFA]) | (uint16_t (regBank [MCP23017_REG_INTFB]) << 8);
+    event.capture = uint16_t (regBank [MCP23017_REG_INTCAPA]) | (uint16_t (regBank [MCP23017_REG_INTCAPB]) << 8);
+    event.gpio = uint16_t (regBank [MCP23017_REG_GPIOA]) | (uint16_t (regBank [MCP23017_REG_GPIOB]) << 8);
+    event.pin = (event.flags == 0) ? -1 : int8_t (__builtin_ctz (event.flags));
+  }
+
+  event.serviced = true;
+  return response;
+}
+
+//============================================================================================//
+/**
+ * @brief This is the supervisor function that manages all user ISRs. When an interrupt is registered
+ * by the host MCU, the `isrSupervisor()` should determine which pin of the IOE caused it and invoke the
+ * associated ISR set by the user. This requires reading the IOE registers INTF and INTCAP, and optionally
+ * GPIO, in a single burst. Reading INTCAP clears the interrupt, so the IOE interrupts do not have to be
+ * disabled while the ISR runs. Then determine which pins caused the interrupt, verify the interrupt
+ * attached to each pin, and call the ISRs. The host MCU interrupt stays attached all the time.
+ * Pins that need to be disarmed after service are disarmed in a single write per port.
+ * 
+ */
+void CSE_MCP23017:: isrSupervisor() {
+  //--------------------------------------------------------------------------------------------//
+  // Read the registers.
+
+  // INTFA, INTFB, INTCAPA, INTCAPB and optionally GPIOA and GPIOB are sequential, so they can
+  // be read in a single burst. The interrupt flag determines which pin caused the interrupt,
+  // and the capture registers hold the port state at the time of the interrupt.
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, F("ISR Supervisor invoked"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, F("Reading registers"));
+
+  uint8_t length = isrReadGpio ? 6 : 4;
+
+  if (readBurst (MCP23017_REG_INTFA, regBank, MCP23017_REG_INTFA, length) == MCP23017_RESP_OK) {
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, F("Success"));
   }
   else {
-    debugPort.println (F("Failed"));
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_IRQ, F("Failed"));
   }
   
-  debugPort.print (F("MCP23017_REG_INTFA : 0x"));
-  debugPort.print (this->regBank [MCP23017_REG_INTFA], HEX);
-  debugPort.print (F(", 0b"));
-  debugPort.println (toBinary (this->regBank [MCP23017_REG_INTFA], 8));
-  debugPort.print (F("MCP23017_REG_INTFB : 0x"));
-  debugPort.print (this->regBank [MCP23017_REG_INTFB], HEX);
-  debugPort.print (F(", 0b"));
-  debugPort.println (toBinary (this->regBank [MCP23017_REG_INTFB], 8));
-
-  debugPort.print (F("INTCAPA : 0x"));
-  debugPort.print (this->regBank [MCP23017_REG_INTCAPA], HEX);
-  debugPort.print (F(", 0b"));
-  debugPort.println (toBinary (this->regBank [MCP23017_REG_INTCAPA], 8));
-  debugPort.print (F("INTCAPB : 0x"));
-  debugPort.print (this->regBank [MCP23017_REG_INTCAPB], HEX);
-  debugPort.print (F(", 0b"));
-  debugPort.println (toBinary (this->regBank [MCP23017_REG_INTCAPB], 8));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F("MCP23017_REG_INTFA : 0x"));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, this->regBank [MCP23017_REG_INTFA], HEX);
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F(", 0b"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, toBinary (this->regBank [MCP23017_REG_INTFA], 8));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F("MCP23017_REG_INTFB : 0x"));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, this->regBank [MCP23017_REG_INTFB], HEX);
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F(", 0b"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, toBinary (this->regBank [MCP23017_REG_INTFB], 8));
+
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F("INTCAPA : 0x"));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, this->regBank [MCP23017_REG_INTCAPA], HEX);
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F(", 0b"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, toBinary (this->regBank [MCP23017_REG_INTCAPA], 8));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F("INTCAPB : 0x"));
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, this->regBank [MCP23017_REG_INTCAPB], HEX);
+  MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F(", 0b"));
+  MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, toBinary (this->regBank [MCP23017_REG_INTCAPB], 8));
 
   //--------------------------------------------------------------------------------------------//
 
@@ -1467,134 +2807,391 @@ void CSE_MCP23017:: isrSupervisor() {
   intPinState = -1;
   intPinCapState = -1;
 
-  // We have two bytes to check. We expect only one bit of either the registers to be a 1.
-  // To find where the bit 1 is, Rsh the bytes 1 bit at a time, and compare it with 0x1.
-  // If it is 1, the final position index will be the pin location.
-  for (int i = 0; i < 2; i++) {
-    for (int j = 0; j < 8; j++) {
-      if (((regBank [MCP23017_REG_INTFA + i] >> j) & 0x1U) == 0x1U) {
-        intPin = int8_t (j + (8 * i));
-        break;
-      }
-    }
-    if (intPin != -1) break;
-  }
-
-  debugPort.print (F("Interrupt occured at "));
-  debugPort.println (intPin);
+  // Combine the flags and captures of both ports into 16-bit words. More than one pin can be
+  // flagged if their edges arrived together. Each set bit is found with a count-trailing-zeros
+  // and then cleared, so every flagged pin is serviced in the same pass.
+  uint16_t intFlags = uint16_t (regBank [MCP23017_REG_INTFA]) | (uint16_t (regBank [MCP23017_REG_INTFB]) << 8);
+  uint16_t intCaptures = uint16_t (regBank [MCP23017_REG_INTCAPA]) | (uint16_t (regBank [MCP23017_REG_INTCAPB]) << 8);
 
   //--------------------------------------------------------------------------------------------//
 
-  if (intPin == -1) { // If the pins couldn't be determined
-    debugPort.println (F("MCP23017 Error : Unable to determine the pin interrupt occured at\n"));
+  if (intFlags == 0) { // If the pins couldn't be determined
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, F("MCP23017 Error : Unable to determine the pin interrupt occured at\n"));
     // return MCP23017_ERROR_UDP;
     // return;
   }
   else {
+    // The lowest flagged pin is reported as the interrupt pin.
+    intPin = int8_t (__builtin_ctz (intFlags));
+    intPinCapState = (intCaptures >> intPin) & 0x1U;
     lastIntPin = intPin;
-    // Read the pin state when interrupt occured.
-    // intPinCapState = regBank[MCP23017_REG_INTCAPA + (intPin >> 3)] & (0x1U << (intPin & 0x7));
-    intPinCapState = (regBank [MCP23017_REG_INTCAPA + (intPin >> 3)] >> (intPin & 0x7)) & 0x1U;
-      
-    //--------------------------------------------------------------------------------------------//
-    // If the interrupt is set for LOW state, we have to read the port register every time
-    // after the ISR is finished and call it again if the state persists.
-    
-    if (isrModeList [intPin] == MCP23017_INT_LOW) {
-      if (intPinCapState == 0) { // If the bit pos is 0
-        bool statePersist = false;
 
-        do {
-          isrPtrList [intPin] (intPin);  // Call the ISR attached to the pin
+    MCP23017_LOG_DEBUG (MCP23017_LOG_IRQ, F("Interrupt occured at "));
+    MCP23017_LOGLN_DEBUG (MCP23017_LOG_IRQ, intPin);
 
-          read (regBank [MCP23017_REG_GPIOA + (intPin >> 3)]);  // Read just the associated reg only to save time
-          intPinState = regBank [MCP23017_REG_GPIOA + (intPin >> 3)] & (0x1U << (intPin & 0x7));
+    serviceFlags (intFlags, intCaptures);
+  }
+}
 
-          if (intPinState == 0) { // If the state persists
-            statePersist = true;
-          }
-        } while (statePersist == true); // Repeat
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Calls the ISRs of a set of flagged pins, and disarms the compare mode pins among them.
+ * A compare mode pin latches the interrupt again as soon as INTCAP is read, because it is still
+ * in the active state, and disabling GPINTEN does not clear the latched flag. So after disarming,
+ * INTF and INTCAP are read once more. This releases the interrupt output, and returns the pins
+ * flagged in the meantime, for example by edges that the ISRs caused. Those that are armed are
+ * serviced in the same way, for up to `MCP23017_SERVICE_PASSES` passes.
+ * 
+ * If no pin was disarmed, nothing was read since the flags, so any new flag is still latched.
+ * It keeps the interrupt output asserted, and `dispatchInterrupt()` services it next.
+ * 
+ * @param flags The flagged pins. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @param captures INTCAP of both ports.
+ */
+void CSE_MCP23017:: serviceFlags (uint16_t flags, uint16_t captures) {
+  for (uint8_t pass = 1; flags != 0; pass++) {
+    uint16_t disarmPins = 0;
+
+    while (flags != 0) {
+      uint8_t pin = uint8_t (__builtin_ctz (flags));
+      flags &= (flags - 1); // Clear the lowest set bit
+
+      if (servicePin (pin, ((captures >> pin) & 0x1U))) {
+        // Compare mode interrupts keep firing while the pin is active. Disarm until re-armed
+        // by dispatchInterrupt().
+        if (isrModeList [pin] != MCP23017_INT_CHANGE) {
+          disarmPins |= (1U << pin);
+        }
       }
     }
 
-    //--------------------------------------------------------------------------------------------//
-    // If the interrupt is set for HIGH state, we have to read the port register every time
-    // after the ISR is finished and call it again if the state persists.
-    
-    else if (isrModeList [intPin] == MCP23017_INT_HIGH) {
-      // The bit that is 1 may appear anywhere on the byte. So we just need to check if the result if > 0.
-      // Instead of shifting 1U to arbitrary left, the reg value can itself be shifted to right as,
-      // (regBank[MCP23017_REG_INTCAPA + (intPin >> 3)] >> (intPin & 0x7)) & 0x1U.
-      // This is only valid for reading the bit pos in a reg.
-      if (intPinCapState == 1) { // If the bit pos is 1
-        bool statePersist = false;
-        
-        do {
-          isrPtrList [intPin] (intPin);  // Call the ISR attached to the pin
-
-          read (regBank [MCP23017_REG_GPIOA + (intPin >> 3)]);  // Read just the associated reg only to save time
-          intPinState = (regBank [MCP23017_REG_GPIOA + (intPin >> 3)] >> (intPin & 0x7)) & 0x1U;
-          
-          if (intPinState == 1) { // If the state persists
-            statePersist = true;
-          }
-        } while (statePersist == true); // Repeat
-      }
+    if ((disarmPins == 0) || (setInterruptEnable (disarmPins, false) != MCP23017_RESP_OK)) {
+      return;
     }
 
-    //--------------------------------------------------------------------------------------------//
-    // If the interrupt is set for CHANGE of state, then we do not need check any registers.
-    // Because the interrupt could have occured when a state of change occured and it occurs only once.
-    
-    else if (isrModeList [intPin] == MCP23017_INT_CHANGE) {
-      isrPtrList [intPin] (intPin);  // Call the ISR attached to the pin
+    disarmedMask |= disarmPins;
+
+    if ((pass >= MCP23017_SERVICE_PASSES) ||
+        (readBurst (MCP23017_REG_INTFA, regBank, MCP23017_REG_INTFA, 4) != MCP23017_RESP_OK)) {
+      return;
     }
 
-    //--------------------------------------------------------------------------------------------//
-    // This is simlar to LOW state interrupt except the ISR is called only once.
+    uint16_t armedPins = (uint16_t (regBank [MCP23017_REG_GPINTENA]) | (uint16_t (regBank [MCP23017_REG_GPINTENB]) << 8)) & ~disarmedMask;
+    flags = (uint16_t (regBank [MCP23017_REG_INTFA]) | (uint16_t (regBank [MCP23017_REG_INTFB]) << 8)) & armedPins;
+    captures = uint16_t (regBank [MCP23017_REG_INTCAPA]) | (uint16_t (regBank [MCP23017_REG_INTCAPB]) << 8);
+  }
+}
 
-    else if (isrModeList [intPin] == MCP23017_INT_FALLING) {
-      if (intPinCapState == 0) { // If the bit pos is 0, that means the pin state changed from HIGH -> LOW
-        isrPtrList [intPin] (intPin);  // Call the ISR attached to the pin
-      }
+//============================================================================================//
+/**
+ * @brief Calls the ISRs attached to a single pin if the captured state of the pin meets the
+ * interrupt mode of the pin. Used by `isrSupervisor()` for each pin flagged in `INTF`.
+ * Events that arrive during the holdoff time of the pin are ignored.
+ * 
+ * @param pin The pin that caused the interrupt. Can be 0-15.
+ * @param capState The state of the pin captured in `INTCAP`.
+ * @return true The ISR was called.
+ * @return false The event was ignored.
+ */
+bool CSE_MCP23017:: servicePin (uint8_t pin, uint8_t capState) {
+  uint32_t now = millis();
+
+  if ((disarmedMask & (1U << pin)) || ((pinEventTime [pin] != 0) && ((now - pinEventTime [pin]) < pinHoldoff (pin)))) {
+    return false; // Latched before the pin was disarmed, or a bounce
+  }
+
+  bool isServed = false;
+
+  //--------------------------------------------------------------------------------------------//
+  // If the interrupt is set for LOW or HIGH state, the ISR is called once here. The pin is
+  // then disarmed, and re-armed after the holdoff. If the state persists, the IOE interrupts
+  // again and the ISR is called again.
+  // This is simlar to FALLING and RISING except for how the pin is re-armed.
+
+  if ((isrModeList [pin] == MCP23017_INT_LOW) || (isrModeList [pin] == MCP23017_INT_FALLING)) {
+    isServed = (capState == 0); // If the bit pos is 0, that means the pin state is LOW
+  }
+  else if ((isrModeList [pin] == MCP23017_INT_HIGH) || (isrModeList [pin] == MCP23017_INT_RISING)) {
+    isServed = (capState == 1); // If the bit pos is 1, that means the pin state is HIGH
+  }
+
+  //--------------------------------------------------------------------------------------------//
+  // If the interrupt is set for CHANGE of state, then we do not need check any registers.
+  // Because the interrupt could have occured when a state of change occured and it occurs only once.
+  
+  else if (isrModeList [pin] == MCP23017_INT_CHANGE) {
+    isServed = true;
+  }
+
+  //--------------------------------------------------------------------------------------------//
+
+  else {
+    MCP23017_LOGLN_ERROR (MCP23017_LOG_IRQ, F("MCP23017 Error : No suitable ISRs found."));
+  }
+
+  if (isServed) {
+    recordLatency (interruptTime);
+    invokeIsr (pin);  // Call the ISR attached to the pin
+    pinEventTime [pin] = now;
+    pinCheckTime [pin] = now;
+  }
+
+  return isServed;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Calls the ISR attached to a pin. The ISR with a context pointer takes precedence.
+ * 
+ * @param pin The pin to call the ISR for. Can be 0-15.
+ */
+void CSE_MCP23017:: invokeIsr (uint8_t pin) {
+  if (isrContextPtrList [pin] != NULL) {
+    isrContextPtrList [pin] (int8_t (pin), isrContextList [pin]);
+  }
+  else if (isrPtrList [pin] != NULL) {
+    isrPtrList [pin] (int8_t (pin));
+  }
+}
+
+//============================================================================================//
+/**
+ * @brief Prepares the IOE for high-rate sampling of the GPIO registers. The address mode is
+ * switched to the byte mode (SEQOP = 1) so that the address pointer does not move after each
+ * read. A single port is sampled in the BANK = 1 mode where the pointer stays on the same
+ * register. Both ports are sampled in the BANK = 0 mode where the pointer toggles between
+ * GPIOA and GPIOB, so the samples alternate between port A and port B.
+ * 
+ * The current access mode is restored by `endSampling()`.
+ * 
+ * @param port The port to sample. Can be `MCP23017_PORT_A`, `MCP23017_PORT_B` or `MCP23017_PORT_AB`.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: beginSampling (uint8_t port) {
+  if (port > MCP23017_PORT_AB) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  if (!samplingActive) {
+    samplingBankMode = getBankMode();
+    samplingAddressMode = getAddressMode();
+  }
+
+  uint8_t response = setAccessMode (((port == MCP23017_PORT_AB) ? MCP23017_BANK_PAIR : MCP23017_BANK_GROUP), MCP23017_ADDR_BYTE);
+
+  if (response == MCP23017_RESP_OK) {
+    samplingActive = true;
+    samplingPort = port;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Captures blocks of GPIO samples into a ring buffer provided by the caller. The address
+ * pointer is parked on the GPIO register once per call, and each block is then fetched with a
+ * single read request with no address write in between. Each block is timestamped with
+ * `micros()` at the time of the request. Sampling stops when the ring buffer is full, when
+ * `blockCount` blocks are captured, or on a read error.
+ * 
+ * The blocks between `ring.tail` and `ring.head` are valid. The consumer must advance `ring.tail`
+ * after consuming a block.
+ * 
+ * @param ring The ring buffer to fill.
+ * @param blockCount The maximum number of blocks to capture.
+ * @return uint16_t The number of blocks captured.
+ */
+uint16_t CSE_MCP23017:: sample (ioeSampleRing_t &ring, uint16_t blockCount) {
+  if ((!samplingActive) || (ring.blocks == NULL) || (ring.size == 0)) {
+    return 0;
+  }
+
+  uint8_t regAddress = (samplingPort == MCP23017_PORT_B) ? MCP23017_REG_GPIOB : MCP23017_REG_GPIOA;
+
+  // Park the address pointer.
+  if (busWrite (uint8_t ((bankMode == GROUP) ? TRANSLATE (regAddress) : regAddress), NULL, 0) != MCP23017_RESP_OK) {
+    writeError (true);
+    return 0;
+  }
+
+  uint16_t blocksCaptured = 0;
+
+  while (blocksCaptured < blockCount) {
+    uint16_t nextHead = (ring.head + 1) % ring.size;
+
+    if (nextHead == ring.tail) { // Ring is full
+      break;
     }
 
-    //--------------------------------------------------------------------------------------------//
-    // This is simlar to HIGH state interrupt except the ISR is called only once.
+    ioeSampleBlock_t &block = ring.blocks [ring.head];
+    block.timestamp = micros();
+    block.length = uint8_t (busReadN (block.samples, MCP23017_SAMPLE_BLOCK_SIZE));
+
+    if (block.length < MCP23017_SAMPLE_BLOCK_SIZE) {
+      readError (true);
 
-    else if (isrModeList [intPin] == MCP23017_INT_RISING) {
-      if (intPinCapState == 1) { // If the bit pos is 0, that means the pin state changed from HIGH -> LOW
-        isrPtrList [intPin] (intPin);  // Call the ISR attached to the pin
+      if (block.length == 0) {
+        break;
       }
     }
 
-    //--------------------------------------------------------------------------------------------//
+    ring.head = nextHead;
+    blocksCaptured++;
+
+    if (block.length < MCP23017_SAMPLE_BLOCK_SIZE) {
+      break;
+    }
+  }
 
+  // Keep the local register bank updated with the last samples.
+  if (blocksCaptured > 0) {
+    ioeSampleBlock_t &lastBlock = ring.blocks [(ring.head + ring.size - 1) % ring.size];
+
+    if (samplingPort == MCP23017_PORT_AB) {
+      // The samples alternate from port A, since every block has an even number of samples.
+      if (lastBlock.length >= 2) {
+        regBank [MCP23017_REG_GPIOA] = lastBlock.samples [(lastBlock.length & 0xFEU) - 2];
+        regBank [MCP23017_REG_GPIOB] = lastBlock.samples [(lastBlock.length & 0xFEU) - 1];
+      }
+    }
     else {
-      debugPort.println (F("MCP23017 Error : No suitable ISRs found."));
-      return;
+      regBank [regAddress] = lastBlock.samples [lastBlock.length - 1];
     }
   }
 
-  write (MCP23017_REG_GPINTENA, regBank [MCP23017_REG_GPINTENA]);
-  write (MCP23017_REG_GPINTENB, regBank [MCP23017_REG_GPINTENB]);
+  return blocksCaptured;
+}
 
-  if (!writeError()) {
-    debugPort.println (F("IOE interrupts have been re-attached"));
-  } else {
-    debugPort.println (F("Failed to re-attach IOE interrupts"));
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Ends the sampling and restores the access mode that was active before `beginSampling()`.
+ * 
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: endSampling() {
+  if (!samplingActive) {
+    return MCP23017_RESP_OK;
   }
 
-  if (attachHostInterrupt() == MCP23017_RESP_OK) {
-    isIntConfigured = true;
-    debugPort.println (F("Host interrupt has been re-attached"));
-    return;
+  uint8_t response = setAccessMode (samplingBankMode, samplingAddressMode);
+
+  if (response == MCP23017_RESP_OK) {
+    samplingActive = false;
   }
-  else {
-    isIntConfigured = false;
-    return;
+
+  return response;
+}
+
+//============================================================================================//
+/**
+ * @brief Streams a sequence of output frames to the latch register of a single port. The IOE is
+ * temporarily put in the BANK = 1 byte mode so that the address pointer stays on the latch
+ * register, and every byte becomes an output update at the pace of the bus clock. The frames are
+ * sent in as few transactions as the Wire buffer allows. The previous access mode is restored
+ * at the end.
+ * 
+ * @param frames The output frames.
+ * @param n The number of frames.
+ * @param port The port to write to. Can be `MCP23017_PORT_A` or `MCP23017_PORT_B`.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017:: streamOutput (const uint8_t *frames, size_t n, uint8_t port) {
+  if ((frames == NULL) || (port > MCP23017_PORT_B)) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  if (n == 0) {
+    return MCP23017_RESP_OK;
+  }
+
+  uint8_t lastBankMode = getBankMode();
+  uint8_t lastAddressMode = getAddressMode();
+  uint8_t response = MCP23017_RESP_OK;
+
+  if ((lastBankMode != MCP23017_BANK_GROUP) || (lastAddressMode != MCP23017_ADDR_BYTE)) {
+    response = setAccessMode (MCP23017_BANK_GROUP, MCP23017_ADDR_BYTE);
+  }
+
+  if (response == MCP23017_RESP_OK) {
+    response = writeChunked (TRANSLATE (MCP23017_REG_OLATA + port), frames, n);
+
+    if (response == MCP23017_RESP_OK) {
+      regBank [MCP23017_REG_OLATA + port] = frames [n - 1];
+    }
+
+    if ((lastBankMode != MCP23017_BANK_GROUP) || (lastAddressMode != MCP23017_ADDR_BYTE)) {
+      uint8_t restoreResponse = setAccessMode (lastBankMode, lastAddressMode);
+      response = (restoreResponse > response) ? restoreResponse : response;
+    }
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Streams a sequence of 16-bit output frames to the latch registers of both ports. The
+ * IOE is temporarily put in the BANK = 0 byte mode so that the address pointer toggles between
+ * OLATA and OLATB. Each frame is sent as the port A byte followed by the port B byte. The
+ * previous access mode is restored at the end.
+ * 
+ * @param frames The output frames. Bits 0-7 = Port A, bits 8-15 = Port B.
+ * @param n The number of frames.
+ * @return uint8_t The I2C response code, or `MCP23017_ERROR_OOR` if the transport can not carry
+ * a whole frame in one transaction.
+ */
+uint8_t CSE_MCP23017:: streamOutput (const uint16_t *frames, size_t n) {
+  // Each transaction must carry whole frames so that the pointer is back at OLATA. The chunk is
+  // the largest even length of the transport, up to the size of the local buffer.
+  uint8_t chunkBuffer [(MCP23017_WIRE_BUFFER_SIZE - 1) & ~0x1U];
+  size_t chunkLength = busMaxLength() & ~size_t (1);
+  chunkLength = (chunkLength > sizeof (chunkBuffer)) ? sizeof (chunkBuffer) : chunkLength;
+
+  if ((frames == NULL) || (chunkLength == 0)) {
+    return MCP23017_ERROR_OOR;
   }
-    // debugPort.println (F("Interrupt has been served"));
+
+  if (n == 0) {
+    return MCP23017_RESP_OK;
+  }
+
+  uint8_t lastBankMode = getBankMode();
+  uint8_t lastAddressMode = getAddressMode();
+  uint8_t response = MCP23017_RESP_OK;
+
+  if ((lastBankMode != MCP23017_BANK_PAIR) || (lastAddressMode != MCP23017_ADDR_BYTE)) {
+    response = setAccessMode (MCP23017_BANK_PAIR, MCP23017_ADDR_BYTE);
+  }
+
+  if (response == MCP23017_RESP_OK) {
+    const size_t framesPerChunk = chunkLength / 2;
+    size_t position = 0;
+
+    while ((position < n) && (response == MCP23017_RESP_OK)) {
+      size_t count = ((n - position) > framesPerChunk) ? framesPerChunk : (n - position);
+
+      for (size_t i = 0; i < count; i++) {
+        chunkBuffer [2 * i] = uint8_t (frames [position + i] & 0xFFU);
+        chunkBuffer [(2 * i) + 1] = uint8_t (frames [position + i] >> 8);
+      }
+
+      response = writeChunked (MCP23017_REG_OLATA, chunkBuffer, (2 * count));
+      position += count;
+    }
+
+    if (response == MCP23017_RESP_OK) {
+      regBank [MCP23017_REG_OLATA] = uint8_t (frames [n - 1] & 0xFFU);
+      regBank [MCP23017_REG_OLATB] = uint8_t (frames [n - 1] >> 8);
+    }
+
+    if ((lastBankMode != MCP23017_BANK_PAIR) || (lastAddressMode != MCP23017_ADDR_BYTE)) {
+      uint8_t restoreResponse = setAccessMode (lastBankMode, lastAddressMode);
+      response = (restoreResponse > response) ? restoreResponse : response;
+    }
+  }
+
+  return response;
 }
 
 //===============================================================================//
@@ -1630,7 +3227,7 @@ String toBinary (uint64_t number, uint16_t width = 0) {
   char binaryBuffer [65] = {0}; // 65 bits - why odd number is because we can split the binary string half
 
   while ((number > 0) || (j < width)) { // Loop until number becomes 0
-    sprintf (&binaryBuffer [i++], "%u", (number & 1)); // AND each LSB with 1, don't use %llu
+    sprintf (&binaryBuffer [i++], "%u", unsigned (number & 1)); // AND each LSB with 1, don't use %llu
     j++;
     number >>= 1; // Shift the number to right
   }
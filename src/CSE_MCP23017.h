@@ -6,6 +6,8 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "CSE_MCP23017_EventQueue.h"
+#include "CSE_MCP23017_Transport.h"
 // #include <string>
 
 //============================================================================================//
@@ -21,7 +23,16 @@
 #define   MCP23017_INTERRUPT_COUNT    0x5U
 #define   MCP23017_INT_MIRROR         0x1U   // To mirror INTA to INTB
 #define   MCP23017_INT_NOMIRROR       0x0U   // To not to mirror INTA to INTB
-#define   MCP23017_MAX_OBJECT         0x6U   // Max no. of objects that support interrupt
+
+#ifndef   MCP23017_MAX_OBJECT
+  #define   MCP23017_MAX_OBJECT       16U   // Max no. of objects that support interrupt, 8 addresses x 2 buses
+#endif
+
+#define   MCP23017_LINE_COUNT         (MCP23017_MAX_OBJECT * 2U) // Host interrupt lines, two per object
+#define   MCP23017_LINE_NONE          0xFFU // End of a shared host pin chain
+#define   MCP23017_INDEX_NONE         0xFFU // Object is not in the global list
+
+static_assert (MCP23017_MAX_OBJECT <= 127, "MCP23017_MAX_OBJECT must be <= 127");
 
 // Pins
 #define   MCP23017_GPA0               0U
@@ -47,6 +58,8 @@
 #define   MCP23017_ERROR_PAE          0x66U  // Pin assignment error
 #define   MCP23017_ERROR_UDP          0x67U  // Unable to determine pin
 #define   MCP23017_ERROR_OF           0x68U  // Operation fail
+#define   MCP23017_ERROR_RF           0x69U  // Device read fail
+#define   MCP23017_ERROR_QF           0x6AU  // Queue full
 
 // Response Codes
 #define   MCP23017_RESP_OK            0x0
@@ -100,6 +113,76 @@
 #define   MCP23017_INT_FALLING        2U  // Interrupt on falling edge
 #define   MCP23017_INT_RISING         3U  // Interrupt on rising edge
 
+// Interrupt Timing
+// Level pins (LOW, HIGH) are held off by default, so that a persisting level calls the ISR at a
+// bounded rate. Edge pins (CHANGE, FALLING, RISING) are not, so that no edge is dropped.
+#define   MCP23017_INT_HOLDOFF_MS     10U // Default time after service during which a level pin is ignored
+#define   MCP23017_INT_EDGE_HOLDOFF_MS 0U  // Default time after service during which an edge pin is ignored
+#define   MCP23017_INT_HOLDOFF_AUTO   0xFFFFU // Holdoff follows the interrupt mode of the pin
+#define   MCP23017_INT_REARM_MS       10U // Default interval for checking if an edge interrupt pin can be re-armed
+
+#ifndef   MCP23017_SERVICE_PASSES
+  #define   MCP23017_SERVICE_PASSES     4U  // Max. flag reads per service, for edges caused by the ISRs
+#endif
+
+// Polling
+#define   MCP23017_POLL_FLOOR_MS      1U  // Default shortest poll interval, used while the inputs are active
+#define   MCP23017_POLL_CEILING_MS    64U // Default longest poll interval, reached when the inputs are idle
+
+// Cache Policies
+#define   MCP23017_CACHE_READTHROUGH  0U  // Read the register from the device before every modification
+#define   MCP23017_CACHE_TRUSTED      1U  // Trust the local register bank and only write to the device
+#define   MCP23017_CACHE_VERIFY       2U  // Trust the local register bank, but re-read it periodically
+#define   MCP23017_CACHE_VERIFY_MS    1000U // Default verify interval in milliseconds
+
+// Register Access Modes
+#define   MCP23017_BANK_PAIR          0U  // BANK = 0, port A and B registers are paired
+#define   MCP23017_BANK_GROUP         1U  // BANK = 1, registers are grouped per port
+#define   MCP23017_ADDR_SEQUENTIAL    0U  // SEQOP = 0, address pointer increments
+#define   MCP23017_ADDR_BYTE          1U  // SEQOP = 1, address pointer does not increment
+
+// Ports
+#define   MCP23017_PORT_A             0U
+#define   MCP23017_PORT_B             1U
+#define   MCP23017_PORT_AB            2U  // Both ports, alternating
+
+// Wire
+#ifndef   MCP23017_WIRE_BUFFER_SIZE
+  #define   MCP23017_WIRE_BUFFER_SIZE   32U // Smallest Wire buffer among the supported cores
+#endif
+
+// Sampling
+#ifndef   MCP23017_SAMPLE_BLOCK_SIZE
+  #define   MCP23017_SAMPLE_BLOCK_SIZE  32U // Samples per read request, must fit the Wire buffer and be even
+#endif
+
+// Batch
+#define   MCP23017_BATCH_MAX_GAP      3U  // Max. clean registers bridged when merging dirty registers into a burst
+
+// Statistics
+// Define MCP23017_ENABLE_STATS as a build flag to collect per-object statistics, see snapshotStats().
+#define   MCP23017_STATS_BUCKETS      16U // Latency histogram buckets, bucket n counts [2^n, 2^(n+1)) us
+
+// Log Levels
+#define   MCP23017_LOG_LEVEL_OFF      0U
+#define   MCP23017_LOG_LEVEL_ERROR    1U  // Failed operations
+#define   MCP23017_LOG_LEVEL_INFO     2U  // Completed configuration steps
+#define   MCP23017_LOG_LEVEL_DEBUG    3U  // Every step and register dump
+
+#ifndef   MCP23017_LOG_LEVEL
+  #define   MCP23017_LOG_LEVEL          MCP23017_LOG_LEVEL_ERROR
+#endif
+
+// Log Categories
+#define   MCP23017_LOG_BUS            0x1U  // I2C transactions
+#define   MCP23017_LOG_IRQ            0x2U  // Interrupt service
+#define   MCP23017_LOG_CONFIG         0x4U  // Pin and interrupt configuration
+#define   MCP23017_LOG_ALL            0x7U
+
+#ifndef   MCP23017_LOG_CATEGORIES
+  #define   MCP23017_LOG_CATEGORIES     MCP23017_LOG_ALL
+#endif
+
 //============================================================================================//
 // Macro Functions
 
@@ -111,21 +194,88 @@
 // The following macro translates alternate mode address to sequential mode.
 // All port A register addresses are even numbers, and only needs a single Rsh.
 // All port B register addresses are odd numbers, and requires a single Rsh and addition of 16.
-#define TRANSLATE(a) ((a >> 1) + (0x10U * (a >> 1)))
+#define TRANSLATE(a) (((a) >> 1) + (0x10U * ((a) & 0x1U)))
 
 // #define READ_PIN_REGISTER(pin, reg, translate) (regBank[reg + (pin >> 3)] = read((reg + (pin >> 3)), translate))
 
+//============================================================================================//
+// Logging
+
+// The log macros print to `debugPort`. Messages above `MCP23017_LOG_LEVEL` are removed by the
+// preprocessor, and messages of categories not in `MCP23017_LOG_CATEGORIES` are removed by the
+// compiler as dead code, so a disabled message costs no code, flash or time. The macros must
+// never be used in interrupt context, including the host interrupt handlers.
+
+#define MCP23017_LOG_EMIT(category, method, ...) do { if ((category) & MCP23017_LOG_CATEGORIES) { debugPort.method (__VA_ARGS__); } } while (0)
+#define MCP23017_LOG_NONE(...) do {} while (0)
+
+#if MCP23017_LOG_LEVEL >= MCP23017_LOG_LEVEL_ERROR
+  #define   MCP23017_LOG_ERROR(category, ...)     MCP23017_LOG_EMIT (category, print, __VA_ARGS__)
+  #define   MCP23017_LOGLN_ERROR(category, ...)   MCP23017_LOG_EMIT (category, println, __VA_ARGS__)
+#else
+  #define   MCP23017_LOG_ERROR(...)     MCP23017_LOG_NONE()
+  #define   MCP23017_LOGLN_ERROR(...)   MCP23017_LOG_NONE()
+#endif
+
+#if MCP23017_LOG_LEVEL >= MCP23017_LOG_LEVEL_INFO
+  #define   MCP23017_LOG_INFO(category, ...)      MCP23017_LOG_EMIT (category, print, __VA_ARGS__)
+  #define   MCP23017_LOGLN_INFO(category, ...)    MCP23017_LOG_EMIT (category, println, __VA_ARGS__)
+#else
+  #define   MCP23017_LOG_INFO(...)      MCP23017_LOG_NONE()
+  #define   MCP23017_LOGLN_INFO(...)    MCP23017_LOG_NONE()
+#endif
+
+#if MCP23017_LOG_LEVEL >= MCP23017_LOG_LEVEL_DEBUG
+  #define   MCP23017_LOG_DEBUG(category, ...)     MCP23017_LOG_EMIT (category, print, __VA_ARGS__)
+  #define   MCP23017_LOGLN_DEBUG(category, ...)   MCP23017_LOG_EMIT (category, println, __VA_ARGS__)
+#else
+  #define   MCP23017_LOG_DEBUG(...)     MCP23017_LOG_NONE()
+  #define   MCP23017_LOGLN_DEBUG(...)   MCP23017_LOG_NONE()
+#endif
+
 //============================================================================================//
 // Typedefs
 
 typedef void (*hostCallback_t)(void);  // The type of callback the host MCU will make
 typedef void (*ioeCallback_t)(int8_t);  // The type of callback the IO expander will make
+typedef void (*ioeContextCallback_t)(int8_t, void*);  // Same as above, with a user context pointer
+
+typedef struct {  // Runtime statistics of an IO expander object, see MCP23017_ENABLE_STATS
+  uint32_t transactions;  // Bus transactions
+  uint32_t bytes; // Data bytes transferred, excluding addresses
+  uint32_t nacks; // Transactions that were not acknowledged
+  uint32_t readUnderruns; // Reads that returned fewer bytes than requested
+  uint32_t interruptsReceived;  // Host interrupts signalled to the object
+  uint32_t interruptsServiced;  // User ISRs called or events collected
+  uint32_t interruptsDropped; // Host interrupts merged into a pending one or lost to a full event queue
+  uint32_t serviceCount;  // Interrupt services timed
+  uint32_t serviceTimeMax;  // Longest service in microseconds
+  uint32_t serviceTimeTotal;  // Sum of the service times in microseconds, for the average
+  uint32_t latency [MCP23017_STATS_BUCKETS];  // Host interrupt to handler time, log2 buckets in microseconds
+} ioeStats_t;
+
+typedef struct {  // A block of GPIO samples fetched in a single read request
+  uint32_t timestamp; // micros() at the time of the request
+  uint8_t length; // Number of valid samples
+  uint8_t samples [MCP23017_SAMPLE_BLOCK_SIZE];
+} ioeSampleBlock_t;
+
+typedef struct {  // Ring buffer of sample blocks, storage provided by the caller
+  ioeSampleBlock_t *blocks; // Block storage
+  uint16_t size;  // Number of blocks in the storage
+  volatile uint16_t head; // Next block to write
+  volatile uint16_t tail; // Next block to read
+} ioeSampleRing_t;
 
 //============================================================================================//
 // Forward declarations
 
 String toBinary (uint64_t number, uint16_t width);
 
+class CSE_MCP23017;
+extern CSE_MCP23017* ioeList [MCP23017_MAX_OBJECT];
+extern CSE_MCP23017_EventQueue ioeEventQueue;
+
 //============================================================================================//
 
 class CSE_MCP23017 {
@@ -137,6 +287,8 @@ class CSE_MCP23017 {
     
     uint8_t resetPin = 0; // GPIO where the reset pin of IOE is connected
     uint8_t deviceAddress = 0; // I2C device address
+    CSE_MCP23017_TwoWire wireTransport; // Default transport
+    CSE_MCP23017_Transport *transport = nullptr; // Custom transport, overrides the default if set
     uint8_t i2cTxBuffer [22] = {0};  // I2C transmit buffer
     bankModes bankMode = PAIR; // 0 (false) = pair mode, 1 (true)= group mode
     uint8_t addressMode = 0; // 0 = sequential mode, 1 = byte mode (no address auto-increment)
@@ -144,15 +296,74 @@ class CSE_MCP23017 {
     int8_t attachPinB = -1; // Interrupt attach pin B
     uint8_t intOutType = 0; // Interrupt output type
     bool isIntConfigured = false; // Is interrupt configured
-    uint8_t ioeIndex = 0;  // IO expander object index
+    bool isrReadGpio = false; // Also read GPIO in the interrupt service burst
+    bool eventQueueEnabled = false; // Queue host interrupts for pollEvents() instead of dispatching
+    volatile uint32_t interruptTime = 0;  // Host micros() at the last host interrupt
+
+#ifdef MCP23017_ENABLE_STATS
+    ioeStats_t stats = {};  // Runtime statistics
+#endif
+    uint8_t ioeIndex = MCP23017_INDEX_NONE;  // IO expander object index in the global list
 
     ioeCallback_t isrPtrList [MCP23017_PINCOUNT] = {NULL};  // Array to hold interrupt function pointers
+    ioeContextCallback_t isrContextPtrList [MCP23017_PINCOUNT] = {NULL};  // Interrupt function pointers with context
+    void *isrContextList [MCP23017_PINCOUNT] = {NULL};  // User context pointers for the above
     uint8_t isrModeList [MCP23017_PINCOUNT] = {0};
+    uint16_t holdoffList [MCP23017_PINCOUNT];  // Holdoff time of each pin in milliseconds, or MCP23017_INT_HOLDOFF_AUTO
+    uint16_t rearmList [MCP23017_PINCOUNT];  // Re-arm check interval of each pin in milliseconds
+    uint32_t pinEventTime [MCP23017_PINCOUNT] = {0};  // Last time each pin was serviced
+    uint32_t pinCheckTime [MCP23017_PINCOUNT] = {0};  // Last time each disarmed pin was checked
+    uint16_t disarmedMask = 0;  // Pins with GPINTEN cleared after service, waiting to be re-armed
+
+    bool pollingEnabled = false;  // Attached ISRs are called by pollChanges() instead of host interrupts
+    uint16_t pollFloor = MCP23017_POLL_FLOOR_MS; // Shortest poll interval in milliseconds
+    uint16_t pollCeiling = MCP23017_POLL_CEILING_MS; // Longest poll interval in milliseconds
+    uint16_t pollInterval = MCP23017_POLL_FLOOR_MS; // Current poll interval in milliseconds
+    uint32_t pollTime = 0;  // Last time the GPIO registers were polled
+    uint16_t pollState = 0; // GPIO of both ports at the last poll
 
     bool deviceReadError; // Set when an I2C read error occurs
     bool deviceWriteError; // Set when an I2C write error occurs
 
+    uint8_t cachePolicy = MCP23017_CACHE_READTHROUGH; // How much the local register bank is trusted
+    uint32_t cacheVerifyInterval = MCP23017_CACHE_VERIFY_MS; // Verify interval for MCP23017_CACHE_VERIFY
+    uint32_t cacheVerifyTime = 0; // Last time the local register bank was verified
+
+    bool batchActive = false; // Set between beginBatch() and commit()
+    uint32_t dirtyMask = 0; // One bit per register in regBank, set when not yet written to the device
+
+    bool samplingActive = false; // Set between beginSampling() and endSampling()
+    uint8_t samplingPort = MCP23017_PORT_A; // The port being sampled
+    uint8_t samplingBankMode = MCP23017_BANK_PAIR; // Bank mode to restore after sampling
+    uint8_t samplingAddressMode = MCP23017_ADDR_SEQUENTIAL; // Address mode to restore after sampling
+
+    uint8_t busProbe();
+    uint8_t busWrite (uint8_t regAddress, const uint8_t *data, size_t length);
+    uint8_t busWriteThenRead (uint8_t regAddress, uint8_t *data, size_t length);
+    size_t busReadN (uint8_t *data, size_t length);
+    size_t busMaxLength();
+    void recordTransfer (uint8_t response, size_t requested, size_t transferred);
+    void recordService (uint32_t startTime);
+    void recordLatency (uint32_t eventTime);
     uint8_t attachHostInterrupt();
+    uint8_t attachHostLine (uint8_t port, int8_t pin, uint8_t mode);
+    void releaseHostLines();
+    int configPinInterrupt (uint8_t pin, uint8_t mode);
+    bool servicePin (uint8_t pin, uint8_t capState);
+    void rearmPins();
+    void serviceFlags (uint16_t flags, uint16_t captures);
+    uint16_t pinHoldoff (uint8_t pin);
+    uint8_t setInterruptEnable (uint16_t mask, bool enable);
+    bool hostInterruptAsserted();
+    void invokeIsr (uint8_t pin);
+    bool cacheReadRequired();
+    uint8_t writeRegister (uint8_t regAddress, uint8_t data, bool translateAddress = false);
+    uint8_t writeRegisterPair (uint8_t regAddress, uint16_t word);
+    uint8_t writeBurst (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length);
+    uint8_t readBurst (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length);
+    uint8_t writeChunked (uint8_t deviceRegister, const uint8_t *data, size_t length);
+    uint8_t modifyLatches (uint16_t mask, uint16_t value, uint16_t toggleMask);
+    uint8_t serviceEvent (ioeEvent_t &event);
     
   public:
     enum gpioPin {  // GPIO pin names list
@@ -183,15 +394,22 @@ class CSE_MCP23017 {
     volatile bool stateReverted;  // 
     int8_t lastIntPin;  // Last interrupt pin
     
-    CSE_MCP23017 (uint8_t resetPin, uint8_t address);
+    CSE_MCP23017 (uint8_t resetPin, uint8_t address = MCP23017_ADDRESS);
+    CSE_MCP23017 (uint8_t resetPin, uint8_t address, TwoWire *wirePort);
+    CSE_MCP23017 (uint8_t resetPin, uint8_t address, CSE_MCP23017_Transport *busTransport);
     ~CSE_MCP23017();
     void reset();
+    void setTransport (CSE_MCP23017_Transport *busTransport);
     uint8_t begin();
     uint8_t write (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length, bool translateAddress = false);
     uint8_t write (uint8_t regAddress, uint8_t byteOne, bool translateAddress = false);
     uint8_t write (bool translateAddress = false);
     uint8_t read (uint8_t regAddress, bool translateAddress = false);
+    uint8_t read (uint8_t regAddress, uint8_t *buffer, uint8_t bufferOffset, uint8_t length, bool translateAddress = false);
     uint8_t readAll (bool translateAddress = false);
+    uint8_t setAccessMode (uint8_t bank, uint8_t sequence);
+    uint8_t getBankMode();
+    uint8_t getAddressMode();
     uint8_t update (uint8_t regOffset, uint8_t *buffer, uint8_t bufferOffset, uint8_t length);
     uint8_t update (uint8_t regOffset, uint8_t byteOne, uint8_t byteTwo);
     bool writeError();
@@ -199,6 +417,11 @@ class CSE_MCP23017 {
     bool readError();
     void readError(bool e);
     bool printOperationStatus (bool input);
+    uint8_t setCachePolicy (uint8_t policy, uint32_t verifyInterval = MCP23017_CACHE_VERIFY_MS);
+    uint8_t getCachePolicy();
+    uint8_t beginBatch();
+    uint8_t commit();
+    bool batchPending();
     uint8_t update (uint8_t regOffset, uint8_t byteOne);
     uint8_t pinMode (uint8_t pin, uint8_t mode);
     uint8_t portMode (uint8_t port, uint8_t mode);
@@ -212,12 +435,37 @@ class CSE_MCP23017 {
     uint8_t portRead (uint8_t port);
     uint8_t setPinInputPolarity (uint8_t pin, uint8_t value);
     uint8_t setPortInputPolarity (uint8_t port, uint8_t value);
+    uint16_t readWord();
+    uint8_t writeWord (uint16_t value);
+    uint8_t modeWord (uint16_t dirMask, uint16_t pullupMask);
+    uint8_t polarityWord (uint16_t polarityMask);
+    uint8_t writeMasked (uint16_t mask, uint16_t value);
+    uint8_t setBits (uint16_t mask);
+    uint8_t clearBits (uint16_t mask);
+    uint8_t toggleBits (uint16_t mask);
+    uint8_t beginSampling (uint8_t port);
+    uint16_t sample (ioeSampleRing_t &ring, uint16_t blockCount);
+    uint8_t endSampling();
+    uint8_t streamOutput (const uint8_t *frames, size_t n, uint8_t port);
+    uint8_t streamOutput (const uint16_t *frames, size_t n);
     uint8_t configInterrupt (int8_t attachPin, uint8_t outType, uint8_t mirror);
     uint8_t configInterrupt (int8_t attachPin1, int8_t attachPin2, uint8_t outType, uint8_t mirror);
     int attachInterrupt (uint8_t pin, ioeCallback_t isr, uint8_t mode);
+    int attachInterrupt (uint8_t pin, ioeContextCallback_t isr, uint8_t mode, void *context);
     void isrSupervisor();
     void dispatchInterrupt();
     bool interruptPending();
+    void setServiceGpioRead (bool enable);
+    uint8_t setInterruptTiming (uint8_t pin, uint16_t holdoff, uint16_t rearm);
+    uint8_t setPolling (bool enable, uint16_t floor = MCP23017_POLL_FLOOR_MS, uint16_t ceiling = MCP23017_POLL_CEILING_MS);
+    uint16_t pollChanges();
+    uint16_t getPollInterval();
+    void setEventQueue (bool enable);
+    bool eventQueueActive();
+    void signalInterrupt (uint32_t timestamp);
+    static bool pollEvents (ioeEvent_t &event);
+    ioeStats_t snapshotStats();
+    void resetStats();
 };
 
 #endif
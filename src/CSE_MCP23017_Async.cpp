@@ -0,0 +1,185 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017.h"
+#include "CSE_MCP23017_Async.h"
+
+//============================================================================================//
+
+CSE_MCP23017_Async:: CSE_MCP23017_Async (CSE_MCP23017_Transport *busTransport) {
+  transport = busTransport;
+
+  // The sequence starts one lap ahead, so these never match a handle until it wraps.
+  for (uint8_t i = 0; i < MCP23017_ASYNC_QUEUE_SIZE; i++) {
+    slots [i].handle = i;
+    slots [i].response = MCP23017_ASYNC_EXPIRED;
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Fills the next free slot and publishes it to `tick()`. The handle is the sequence number
+ * of the transaction, which always maps to the same slot as the head because the queue size
+ * divides 2^8.
+ *
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_QF` or `MCP23017_ERROR_OOR`.
+ */
+uint8_t CSE_MCP23017_Async:: enqueue (uint8_t type, uint8_t address, uint8_t regAddress, const uint8_t *data, uint8_t *target, size_t length,
+  ioeAsyncCallback_t callback, void *context, ioeAsyncHandle_t *handle) {
+
+  if ((length == 0) || (length > MCP23017_ASYNC_DATA_SIZE) || (length > transport->maxLength())) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  uint8_t h = __atomic_load_n (&head, __ATOMIC_RELAXED);
+  uint8_t t = __atomic_load_n (&tail, __ATOMIC_ACQUIRE);
+
+  if (uint8_t (h - t) >= MCP23017_ASYNC_QUEUE_SIZE) {
+    return MCP23017_ERROR_QF;
+  }
+
+  ioeTransaction_t &slot = slots [h & (MCP23017_ASYNC_QUEUE_SIZE - 1)];
+  slot.handle = sequence;
+  slot.type = type;
+  slot.address = address;
+  slot.regAddress = regAddress;
+  slot.length = uint8_t (length);
+  slot.response = MCP23017_ASYNC_PENDING;
+  slot.target = target;
+  slot.callback = callback;
+  slot.context = context;
+
+  if (type == MCP23017_ASYNC_WRITE) {
+    memcpy (slot.data, data, length); // The caller's buffer may be reused right away
+  }
+
+  if (handle != NULL) {
+    *handle = sequence;
+  }
+
+  sequence++;
+  __atomic_store_n (&head, uint8_t (h + 1), __ATOMIC_RELEASE);
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Queues a write of one or more consecutive registers. The data is copied, so the
+ * buffer can be reused as soon as this returns.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The bytes to write.
+ * @param length The number of bytes, up to `MCP23017_ASYNC_DATA_SIZE`.
+ * @param callback Called from `tick()` when the write completes. Optional.
+ * @param context Passed to the callback.
+ * @param handle The handle of the transaction is saved here, for `status()`. Optional.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_QF` if the queue is full, or
+ * `MCP23017_ERROR_OOR` if the length is invalid.
+ */
+uint8_t CSE_MCP23017_Async:: write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length,
+  ioeAsyncCallback_t callback, void *context, ioeAsyncHandle_t *handle) {
+  return enqueue (MCP23017_ASYNC_WRITE, address, regAddress, data, NULL, length, callback, context, handle);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Queues a read of one or more consecutive registers. The bytes read are passed to the
+ * callback, and also copied to `data` if it is not `NULL`. The buffer must stay valid until the
+ * transaction completes.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The buffer for the bytes read, or `NULL`.
+ * @param length The number of bytes, up to `MCP23017_ASYNC_DATA_SIZE`.
+ * @param callback Called from `tick()` when the read completes. Optional.
+ * @param context Passed to the callback.
+ * @param handle The handle of the transaction is saved here, for `status()`. Optional.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_QF` if the queue is full, or
+ * `MCP23017_ERROR_OOR` if the length is invalid.
+ */
+uint8_t CSE_MCP23017_Async:: writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length,
+  ioeAsyncCallback_t callback, void *context, ioeAsyncHandle_t *handle) {
+  return enqueue (MCP23017_ASYNC_READ, address, regAddress, NULL, data, length, callback, context, handle);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Runs the oldest queued transaction, if any, and calls its callback. This blocks for
+ * one transaction only. Call it repeatedly from the context that owns the bus.
+ *
+ * @return true A transaction was run.
+ * @return false The queue was empty.
+ */
+bool CSE_MCP23017_Async:: tick() {
+  uint8_t t = __atomic_load_n (&tail, __ATOMIC_RELAXED);
+
+  if (t == __atomic_load_n (&head, __ATOMIC_ACQUIRE)) {
+    return false;
+  }
+
+  ioeTransaction_t &slot = slots [t & (MCP23017_ASYNC_QUEUE_SIZE - 1)];
+  uint8_t response;
+
+  if (slot.type == MCP23017_ASYNC_WRITE) {
+    response = transport->write (slot.address, slot.regAddress, slot.data, slot.length);
+  }
+  else {
+    response = transport->writeThenRead (slot.address, slot.regAddress, slot.data, slot.length);
+
+    if ((response == MCP23017_RESP_OK) && (slot.target != NULL)) {
+      memcpy (slot.target, slot.data, slot.length);
+    }
+  }
+
+  if (slot.callback != NULL) {
+    slot.callback (slot.handle, response, slot.data, slot.context);
+  }
+
+  // The slot stays intact after this until the producer reuses it.
+  __atomic_store_n (&slot.response, response, __ATOMIC_RELEASE);
+  __atomic_store_n (&tail, uint8_t (t + 1), __ATOMIC_RELEASE);
+  return true;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the state of a queued transaction. Must be called from the context that queues
+ * the transactions. The result of a completed transaction is available until its slot is reused
+ * by a later transaction. The slot keeps the handle of its transaction, so a handle whose slot has
+ * been reused is reported as expired, not as the state of the newer transaction.
+ *
+ * @param handle The handle saved by `write()` or `writeThenRead()`.
+ * @return uint8_t `MCP23017_ASYNC_PENDING`, `MCP23017_ASYNC_EXPIRED`, or the response code of the
+ * completed transaction.
+ */
+uint8_t CSE_MCP23017_Async:: status (ioeAsyncHandle_t handle) {
+  ioeTransaction_t &slot = slots [handle & (MCP23017_ASYNC_QUEUE_SIZE - 1)];
+
+  // Only the producer writes the handle of a slot, so it can be read here without ordering.
+  if (slot.handle != handle) {
+    return MCP23017_ASYNC_EXPIRED;
+  }
+
+  return __atomic_load_n (&slot.response, __ATOMIC_ACQUIRE);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the number of transactions queued or running.
+ *
+ * @return uint8_t The number of transactions.
+ */
+uint8_t CSE_MCP23017_Async:: pending() {
+  return uint8_t (__atomic_load_n (&head, __ATOMIC_ACQUIRE) - __atomic_load_n (&tail, __ATOMIC_ACQUIRE));
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the number of free slots in the queue.
+ *
+ * @return uint8_t The number of free slots.
+ */
+uint8_t CSE_MCP23017_Async:: available() {
+  return uint8_t (MCP23017_ASYNC_QUEUE_SIZE - pending());
+}
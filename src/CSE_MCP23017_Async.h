@@ -0,0 +1,88 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_ASYNC_H
+#define CSE_MCP23017_ASYNC_H
+
+#include "CSE_MCP23017_Transport.h"
+
+//============================================================================================//
+
+#ifndef   MCP23017_ASYNC_QUEUE_SIZE
+  #define   MCP23017_ASYNC_QUEUE_SIZE   8U  // Transaction queue length, must be a power of 2 and <= 128
+#endif
+
+#ifndef   MCP23017_ASYNC_DATA_SIZE
+  #define   MCP23017_ASYNC_DATA_SIZE    22U // Max. data bytes per queued transaction, one full register burst
+#endif
+
+static_assert (((MCP23017_ASYNC_QUEUE_SIZE & (MCP23017_ASYNC_QUEUE_SIZE - 1)) == 0) && (MCP23017_ASYNC_QUEUE_SIZE <= 128),
+  "MCP23017_ASYNC_QUEUE_SIZE must be a power of 2 and <= 128");
+
+#define   MCP23017_ASYNC_WRITE        0U  // Transaction types
+#define   MCP23017_ASYNC_READ         1U
+
+#define   MCP23017_ASYNC_PENDING      0xFEU // Status of a transaction that is queued or running
+#define   MCP23017_ASYNC_EXPIRED      0xFFU // Status of a handle whose slot has been reused
+
+//============================================================================================//
+// Typedefs
+
+typedef uint32_t ioeAsyncHandle_t; // Sequence number of a queued transaction, unique until it wraps at 2^32
+
+typedef void (*ioeAsyncCallback_t)(ioeAsyncHandle_t handle, uint8_t response, const uint8_t *data, void *context);
+
+typedef struct {  // A queued register transaction
+  ioeAsyncHandle_t handle;  // Sequence number of the transaction in this slot
+  uint8_t type; // MCP23017_ASYNC_WRITE or MCP23017_ASYNC_READ
+  uint8_t address;  // Device address
+  uint8_t regAddress; // Absolute register address
+  uint8_t length; // Data bytes
+  uint8_t response; // Response code, valid once completed
+  uint8_t *target;  // Reads are copied here, if not NULL
+  ioeAsyncCallback_t callback;  // Called on completion, if not NULL
+  void *context;  // Passed to the callback
+  uint8_t data [MCP23017_ASYNC_DATA_SIZE];  // Write data, or the bytes read
+} ioeTransaction_t;
+
+//============================================================================================//
+/**
+ * @brief A bounded, allocation-free queue of register transactions over a transport. The caller
+ * queues writes and reads for any device on the bus and returns immediately. The transactions
+ * are run in order by `tick()`, which can be called from the main loop, a timer, or a separate
+ * task or core. Completion is reported through an optional callback, called from `tick()`, or
+ * can be polled with `status()`.
+ *
+ * The queue is single-producer, single-consumer. One context queues and polls, and one context
+ * calls `tick()`. They may run in parallel. The transport must not be used by anything else,
+ * including a `CSE_MCP23017` object, while transactions are pending.
+ *
+ * Register addresses are absolute, so they must match the BANK mode of the device. The queued
+ * writes bypass the register cache of any `CSE_MCP23017` object for the same device.
+ *
+ */
+class CSE_MCP23017_Async {
+  private:
+    CSE_MCP23017_Transport *transport;  // The bus the transactions are run on
+    ioeTransaction_t slots [MCP23017_ASYNC_QUEUE_SIZE];
+    uint8_t head = 0; // Next slot to queue, producer only
+    uint8_t tail = 0; // Next slot to run, consumer only
+    ioeAsyncHandle_t sequence = MCP23017_ASYNC_QUEUE_SIZE; // Next handle, producer only
+
+    uint8_t enqueue (uint8_t type, uint8_t address, uint8_t regAddress, const uint8_t *data, uint8_t *target, size_t length,
+      ioeAsyncCallback_t callback, void *context, ioeAsyncHandle_t *handle);
+
+  public:
+    CSE_MCP23017_Async (CSE_MCP23017_Transport *busTransport);
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length,
+      ioeAsyncCallback_t callback = NULL, void *context = NULL, ioeAsyncHandle_t *handle = NULL);
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length,
+      ioeAsyncCallback_t callback = NULL, void *context = NULL, ioeAsyncHandle_t *handle = NULL);
+    bool tick();
+    uint8_t status (ioeAsyncHandle_t handle);
+    uint8_t pending();
+    uint8_t available();
+};
+
+//============================================================================================//
+
+#endif
@@ -0,0 +1,105 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017.h"
+#include "CSE_MCP23017_Counter.h"
+
+//============================================================================================//
+
+CSE_MCP23017_Counter:: CSE_MCP23017_Counter (CSE_MCP23017_Transport *transport, bool useRepeatedStart) {
+  target = transport;
+  repeatedStart = useRepeatedStart;
+  reset();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Clears all the counters.
+ *
+ */
+void CSE_MCP23017_Counter:: reset() {
+  count.transactions = 0;
+  count.starts = 0;
+  count.stops = 0;
+  count.bytes = 0;
+  count.bits = 0;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns a copy of the counters.
+ *
+ * @return ioeBusCount_t The counters.
+ */
+ioeBusCount_t CSE_MCP23017_Counter:: counts() {
+  return count;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the time the counted traffic occupies the bus.
+ *
+ * @param clock The I2C clock in Hz, such as 100000, 400000 or 1700000.
+ * @return uint32_t The bus time in microseconds.
+ */
+uint32_t CSE_MCP23017_Counter:: busTime (uint32_t clock) {
+  return uint32_t ((uint64_t (count.bits) * 1000000UL) / clock);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Counts a single frame on the bus: a START, the device address byte, the payload and
+ * optionally a STOP.
+ *
+ * @param payloadBytes The bytes after the address byte.
+ * @param stop Whether the frame ends with a STOP.
+ */
+void CSE_MCP23017_Counter:: addFrame (size_t payloadBytes, bool stop) {
+  count.starts++;
+  count.bytes += payloadBytes;
+  count.bits += MCP23017_I2C_CONDITION_BITS + ((1 + payloadBytes) * MCP23017_I2C_BYTE_BITS);
+
+  if (stop) {
+    count.stops++;
+    count.bits += MCP23017_I2C_CONDITION_BITS;
+  }
+}
+
+//============================================================================================//
+
+uint8_t CSE_MCP23017_Counter:: begin (uint8_t address) {
+  return target->begin (address);
+}
+
+uint8_t CSE_MCP23017_Counter:: ioconBits() {
+  return target->ioconBits();
+}
+
+uint8_t CSE_MCP23017_Counter:: probe (uint8_t address) {
+  count.transactions++;
+  addFrame (0, true);
+  return target->probe (address);
+}
+
+uint8_t CSE_MCP23017_Counter:: write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) {
+  count.transactions++;
+  addFrame (1 + length, true);  // Register address and data
+  return target->write (address, regAddress, data, length);
+}
+
+uint8_t CSE_MCP23017_Counter:: writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) {
+  count.transactions++;
+  addFrame (1, !repeatedStart); // Register address
+  addFrame (length, true);  // Data
+  return target->writeThenRead (address, regAddress, data, length);
+}
+
+size_t CSE_MCP23017_Counter:: readN (uint8_t address, uint8_t *data, size_t length) {
+  count.transactions++;
+  addFrame (length, true);
+  return target->readN (address, data, length);
+}
+
+size_t CSE_MCP23017_Counter:: maxLength() {
+  return target->maxLength();
+}
@@ -0,0 +1,57 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_COUNTER_H
+#define CSE_MCP23017_COUNTER_H
+
+#include "CSE_MCP23017_Transport.h"
+
+//============================================================================================//
+
+#define   MCP23017_I2C_BYTE_BITS      9U  // 8 data bits and the ACK bit
+#define   MCP23017_I2C_CONDITION_BITS 1U  // Approx. length of a START, repeated START or STOP
+
+//============================================================================================//
+// Typedefs
+
+typedef struct {  // Bus traffic counted by CSE_MCP23017_Counter
+  uint32_t transactions;  // Calls to the transport primitives
+  uint32_t starts;  // START and repeated START conditions
+  uint32_t stops; // STOP conditions
+  uint32_t bytes; // Payload bytes, excluding the device address bytes
+  uint32_t bits;  // Bit times on the bus, including address bytes, ACKs and conditions
+} ioeBusCount_t;
+
+//============================================================================================//
+/**
+ * @brief A transport that counts the I2C traffic of another transport and forwards every call
+ * to it. Wrap the real transport (or `CSE_MCP23017_Sim`) with this to measure the bus cost of
+ * the library calls. The bit count assumes the I2C framing, so `busTime()` gives the time the
+ * traffic occupies the bus at a given clock, excluding clock stretching and host overhead.
+ *
+ */
+class CSE_MCP23017_Counter final : public CSE_MCP23017_Transport {
+  private:
+    CSE_MCP23017_Transport *target; // The transport that does the work
+    ioeBusCount_t count;  // Counted traffic
+    bool repeatedStart; // writeThenRead() uses a repeated START instead of STOP + START
+
+    void addFrame (size_t payloadBytes, bool stop);
+
+  public:
+    CSE_MCP23017_Counter (CSE_MCP23017_Transport *transport, bool useRepeatedStart = true);
+    void reset();
+    ioeBusCount_t counts();
+    uint32_t busTime (uint32_t clock);
+
+    uint8_t begin (uint8_t address) override;
+    uint8_t ioconBits() override;
+    uint8_t probe (uint8_t address) override;
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override;
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override;
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override;
+    size_t maxLength() override;
+};
+
+//============================================================================================//
+
+#endif
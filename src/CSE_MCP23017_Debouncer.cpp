@@ -0,0 +1,107 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017_Debouncer.h"
+
+//============================================================================================//
+
+CSE_MCP23017_Debouncer:: CSE_MCP23017_Debouncer (uint8_t sampleCount, uint16_t initial) {
+  setSamples (sampleCount);
+  reset (initial);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the debounced state without filtering and clears the counters and edges.
+ *
+ * @param initial The state of the pins, bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+void CSE_MCP23017_Debouncer:: reset (uint16_t initial) {
+  for (uint8_t i = 0; i < MCP23017_DEBOUNCE_PLANES; i++) {
+    count [i] = 0;
+  }
+
+  stable = initial;
+  risen = 0;
+  fallen = 0;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the number of consecutive samples a pin must differ from its debounced state
+ * before the change is accepted. With 1, every change is accepted at once. The counts in
+ * progress are kept.
+ *
+ * @param sampleCount 1 to `MCP23017_DEBOUNCE_MAX_SAMPLES`. Other values are clamped.
+ */
+void CSE_MCP23017_Debouncer:: setSamples (uint8_t sampleCount) {
+  if (sampleCount < 1) {
+    sampleCount = 1;
+  }
+  else if (sampleCount > MCP23017_DEBOUNCE_MAX_SAMPLES) {
+    sampleCount = MCP23017_DEBOUNCE_MAX_SAMPLES;
+  }
+
+  samples = sampleCount;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Adds a sample of all the pins and updates the debounced state.
+ *
+ * @param sample The GPIO value, bits 0-7 = Port A, bits 8-15 = Port B.
+ * @return uint16_t The pins whose debounced state changed.
+ */
+uint16_t CSE_MCP23017_Debouncer:: update (uint16_t sample) {
+  uint16_t differ = sample ^ stable;
+  uint16_t carry = differ;  // Increment the pins that differ
+  uint16_t reached = differ;  // Pins whose new count equals the sample count
+
+  for (uint8_t i = 0; i < MCP23017_DEBOUNCE_PLANES; i++) {
+    uint16_t plane = count [i];
+    uint16_t next = (plane ^ carry) & differ; // Add the carry, and clear the pins that match
+    carry &= plane;
+    count [i] = next;
+    reached &= ((samples >> i) & 0x1U) ? next : uint16_t (~next);
+  }
+
+  for (uint8_t i = 0; i < MCP23017_DEBOUNCE_PLANES; i++) {
+    count [i] &= uint16_t (~reached);
+  }
+
+  stable ^= reached;
+  risen = reached & stable;
+  fallen = reached & uint16_t (~stable);
+
+  return reached;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the debounced state of the pins.
+ *
+ * @return uint16_t The state, bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+uint16_t CSE_MCP23017_Debouncer:: state() {
+  return stable;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the pins that became high in the last update.
+ *
+ * @return uint16_t The pin mask.
+ */
+uint16_t CSE_MCP23017_Debouncer:: rose() {
+  return risen;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the pins that became low in the last update.
+ *
+ * @return uint16_t The pin mask.
+ */
+uint16_t CSE_MCP23017_Debouncer:: fell() {
+  return fallen;
+}
@@ -0,0 +1,46 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_DEBOUNCER_H
+#define CSE_MCP23017_DEBOUNCER_H
+
+#include <stdint.h>
+
+//============================================================================================//
+
+#define   MCP23017_DEBOUNCE_PLANES    4U  // Bit planes of the vertical counter
+#define   MCP23017_DEBOUNCE_MAX_SAMPLES 15U // Max. samples, limited by the counter width
+#define   MCP23017_DEBOUNCE_SAMPLES   4U  // Default samples
+
+//============================================================================================//
+/**
+ * @brief Debounces all 16 pins of an IO expander at once. Each pin has a 4-bit counter, stored
+ * as a vertical counter: bit n of the counters of all the pins is held in one 16-bit plane. A
+ * pin's counter counts the samples that differ from its debounced state and is cleared by any
+ * sample that matches. The state changes when the count reaches the set number of samples. The
+ * cost of an update is a few word operations, the same for any number of changing pins.
+ *
+ * The samples can be the GPIO value from `readWord()` in a polling loop, or the `gpio` of the
+ * events from `pollEvents()`. One object is needed per device. Nothing is allocated.
+ *
+ */
+class CSE_MCP23017_Debouncer {
+  private:
+    uint16_t count [MCP23017_DEBOUNCE_PLANES];  // Vertical counter, plane n holds bit n
+    uint16_t stable;  // Debounced state
+    uint16_t risen; // Pins that became high in the last update
+    uint16_t fallen;  // Pins that became low in the last update
+    uint8_t samples;  // Samples needed to accept a change
+
+  public:
+    CSE_MCP23017_Debouncer (uint8_t sampleCount = MCP23017_DEBOUNCE_SAMPLES, uint16_t initial = 0);
+    void reset (uint16_t initial);
+    void setSamples (uint8_t sampleCount);
+    uint16_t update (uint16_t sample);
+    uint16_t state();
+    uint16_t rose();
+    uint16_t fell();
+};
+
+//============================================================================================//
+
+#endif
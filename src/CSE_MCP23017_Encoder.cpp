@@ -0,0 +1,282 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017_Encoder.h"
+
+//============================================================================================//
+
+// Position change for each transition, indexed by (previous AB << 2) | current AB. The value 2
+// marks an invalid transition where both pins changed.
+static const int8_t encoderTable [16] = {
+  0, -1, 1, 2,
+  1, 0, 2, -1,
+  -1, 2, 0, 1,
+  2, 1, -1, 0
+};
+
+//============================================================================================//
+
+CSE_MCP23017_Encoder:: CSE_MCP23017_Encoder (CSE_MCP23017 *ioExpander) {
+  ioe = ioExpander;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Assigns two pins to a new encoder. Clockwise rotation is assumed to be the direction in
+ * which A leads B, and counts up. Swap the pins to reverse it.
+ *
+ * @param pinA The pin of channel A. Can be 0-15.
+ * @param pinB The pin of channel B. Can be 0-15.
+ * @return int8_t The encoder number, or -1 if the pins are invalid, already used, or all the
+ * encoders are taken.
+ */
+int8_t CSE_MCP23017_Encoder:: attach (uint8_t pinA, uint8_t pinB) {
+  if ((count >= MCP23017_ENCODER_MAX) || (pinA >= MCP23017_PINCOUNT) || (pinB >= MCP23017_PINCOUNT) || (pinA == pinB)) {
+    return -1;
+  }
+
+  uint16_t pins = (1U << pinA) | (1U << pinB);
+
+  if (pinMask & pins) {
+    return -1;
+  }
+
+  this->pinA [count] = pinA;
+  this->pinB [count] = pinB;
+  position [count] = 0;
+  errorCount [count] = 0;
+  windowPosition [count] = 0;
+  speed [count] = 0;
+  pinMask |= pins;
+
+  return int8_t (count++);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the encoder pins as inputs with pull-ups and takes their current state. With
+ * `interruptDriven`, a change interrupt with no holdoff is attached to each pin, and the GPIO
+ * registers are added to the interrupt service burst. This requires `configInterrupt()` on the
+ * IOE before this, and `dispatchInterrupt()` in the main loop.
+ *
+ * @param interruptDriven `true` to update the encoders from the interrupts of the IOE.
+ * @return uint8_t `MCP23017_RESP_OK` or the first error code.
+ */
+uint8_t CSE_MCP23017_Encoder:: begin (bool interruptDriven) {
+  uint8_t response = MCP23017_RESP_OK;
+  uint16_t pending = pinMask;
+
+  while ((pending != 0) && (response == MCP23017_RESP_OK)) {
+    uint8_t pin = uint8_t (__builtin_ctz (pending));
+    pending &= (pending - 1);
+    response = ioe->pinMode (pin, INPUT_PULLUP);
+
+    if ((response == MCP23017_RESP_OK) && interruptDriven) {
+      ioe->setInterruptTiming (pin, 0, MCP23017_INT_REARM_MS);  // Every edge counts
+      response = uint8_t (ioe->attachInterrupt (pin, edgeIsr, MCP23017_INT_CHANGE, this));
+    }
+  }
+
+  if (interruptDriven) {
+    ioe->setServiceGpioRead (true);
+  }
+
+  lastState = ioe->readWord();
+  windowTime = millis();
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Called by `isrSupervisor()` for each flagged encoder pin. The registers are already in
+ * the local register bank, so all the encoders are updated on the first call of each service.
+ *
+ */
+void CSE_MCP23017_Encoder:: edgeIsr (int8_t pin, void *context) {
+  CSE_MCP23017_Encoder *self = static_cast <CSE_MCP23017_Encoder*> (context);
+  CSE_MCP23017 *ioe = self->ioe;
+
+  uint16_t flags = uint16_t (ioe->regBank [MCP23017_REG_INTFA]) | (uint16_t (ioe->regBank [MCP23017_REG_INTFB]) << 8);
+
+  if (pin != int8_t (__builtin_ctz (flags & self->pinMask))) {
+    return; // Already updated in this service
+  }
+
+  self->update (flags,
+    uint16_t (ioe->regBank [MCP23017_REG_INTCAPA]) | (uint16_t (ioe->regBank [MCP23017_REG_INTCAPB]) << 8),
+    uint16_t (ioe->regBank [MCP23017_REG_GPIOA]) | (uint16_t (ioe->regBank [MCP23017_REG_GPIOB]) << 8));
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Moves all the encoders from the last state to a new one.
+ *
+ * @param state The pin states, bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+void CSE_MCP23017_Encoder:: step (uint16_t state) {
+  if (((state ^ lastState) & pinMask) == 0) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    uint8_t previous = uint8_t ((((lastState >> pinA [i]) & 0x1U) << 1) | ((lastState >> pinB [i]) & 0x1U));
+    uint8_t current = uint8_t ((((state >> pinA [i]) & 0x1U) << 1) | ((state >> pinB [i]) & 0x1U));
+    int8_t delta = encoderTable [(previous << 2) | current];
+
+    if (delta == 2) {
+      errorCount [i]++;
+    }
+    else {
+      position [i] += delta;
+    }
+  }
+
+  lastState = state;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Updates all the encoders from a register snapshot. The captured state is used for the
+ * pins of the ports with a flagged interrupt. The pins of the other ports have not changed
+ * since the last interrupt, so their last state is used.
+ *
+ * @param flags `INTF` of both ports.
+ * @param capture `INTCAP` of both ports.
+ * @param gpio `GPIO` of both ports, read after `INTCAP`.
+ */
+void CSE_MCP23017_Encoder:: update (uint16_t flags, uint16_t capture, uint16_t gpio) {
+  uint16_t capturedPorts = ((flags & 0x00FFU) ? 0x00FFU : 0) | ((flags & 0xFF00U) ? 0xFF00U : 0);
+
+  step ((capture & capturedPorts) | (lastState & uint16_t (~capturedPorts)));
+  step (gpio);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Updates all the encoders from an event of `pollEvents()`. Only pass the events of the
+ * IOE the encoders are on.
+ *
+ * @param event A serviced event.
+ */
+void CSE_MCP23017_Encoder:: update (const ioeEvent_t &event) {
+  if (event.serviced) {
+    update (event.flags, event.capture, event.gpio);
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads the GPIO registers in one transaction and updates all the encoders. Use this
+ * without interrupts. It must be called at least once per edge to not lose counts.
+ *
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017_Encoder:: poll() {
+  uint16_t state = ioe->readWord();
+
+  if (ioe->readError()) {
+    ioe->readError (false);
+    return MCP23017_ERROR_RF;
+  }
+
+  step (state);
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the position of an encoder. Interrupts are disabled while it is copied, so it
+ * is safe to call when the encoders are updated from another context.
+ *
+ * @param encoder The encoder number.
+ * @return int32_t The position in quarter steps. 0 if the encoder number is invalid.
+ */
+int32_t CSE_MCP23017_Encoder:: read (uint8_t encoder) {
+  if (encoder >= count) {
+    return 0;
+  }
+
+  noInterrupts();
+  int32_t value = position [encoder];
+  interrupts();
+
+  return value;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the position of an encoder, for example to zero it.
+ *
+ * @param encoder The encoder number.
+ * @param value The new position in quarter steps.
+ */
+void CSE_MCP23017_Encoder:: write (uint8_t encoder, int32_t value) {
+  if (encoder < count) {
+    noInterrupts();
+    windowPosition [encoder] += value - position [encoder];
+    position [encoder] = value;
+    interrupts();
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Measures the velocity of all the encoders once the velocity window has elapsed.
+ *
+ */
+void CSE_MCP23017_Encoder:: updateVelocity() {
+  uint32_t now = millis();
+  uint32_t elapsed = now - windowTime;
+
+  if (elapsed < velocityWindow) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    int32_t current = read (i);
+    speed [i] = int32_t ((int64_t (current - windowPosition [i]) * 1000) / int32_t (elapsed));
+    windowPosition [i] = current;
+  }
+
+  windowTime = now;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the velocity of an encoder, averaged over the last velocity window.
+ *
+ * @param encoder The encoder number.
+ * @return int32_t The velocity in quarter steps per second. Positive when counting up.
+ */
+int32_t CSE_MCP23017_Encoder:: velocity (uint8_t encoder) {
+  if (encoder >= count) {
+    return 0;
+  }
+
+  updateVelocity();
+  return speed [encoder];
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the time over which the velocity is averaged. Longer windows give smoother and
+ * finer readings at low speeds, but react slower.
+ *
+ * @param window The window in milliseconds. 0 is treated as 1.
+ */
+void CSE_MCP23017_Encoder:: setVelocityWindow (uint16_t window) {
+  velocityWindow = (window == 0) ? 1 : window;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the number of invalid transitions of an encoder. Each one is a lost count,
+ * caused by the encoder turning faster than the updates.
+ *
+ * @param encoder The encoder number.
+ * @return uint16_t The number of invalid transitions.
+ */
+uint16_t CSE_MCP23017_Encoder:: errors (uint8_t encoder) {
+  return (encoder < count) ? errorCount [encoder] : 0;
+}
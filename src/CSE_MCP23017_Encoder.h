@@ -0,0 +1,66 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_ENCODER_H
+#define CSE_MCP23017_ENCODER_H
+
+#include "CSE_MCP23017.h"
+
+//============================================================================================//
+
+#define   MCP23017_ENCODER_MAX        8U  // Max. encoders per IO expander, one per pin pair
+#define   MCP23017_ENCODER_VELOCITY_MS 100U // Default velocity measurement window in milliseconds
+
+//============================================================================================//
+/**
+ * @brief Decodes up to 8 quadrature encoders on the pins of one IO expander. Each encoder uses
+ * any two input pins. All the encoders are decoded together from one snapshot of the `INTF`,
+ * `INTCAP` and `GPIO` registers. The snapshot holds two states: the pins as captured at the
+ * interrupt, and as they are now. Both are fed to a transition table. So a second step that
+ * happens before the interrupt is serviced is still counted.
+ *
+ * Position is counted in quarter steps (every edge). Invalid transitions, where both pins
+ * changed between two states, are not counted but are reported by `errors()`.
+ *
+ * The snapshots can come from three sources:
+ *  - With `begin (true)`, a change interrupt is attached to the encoder pins. `isrSupervisor()`
+ *    then reads the registers in one burst, and the encoders are updated from it.
+ *  - From the events of `pollEvents()`, by calling `update (event)`.
+ *  - By polling, with `poll()`, which reads the GPIO registers in one transaction.
+ *
+ */
+class CSE_MCP23017_Encoder {
+  private:
+    CSE_MCP23017 *ioe;  // The IO expander the encoders are on
+    uint8_t count = 0;  // Encoders attached
+    uint8_t pinA [MCP23017_ENCODER_MAX];
+    uint8_t pinB [MCP23017_ENCODER_MAX];
+    int32_t position [MCP23017_ENCODER_MAX];  // Signed position in quarter steps
+    uint16_t errorCount [MCP23017_ENCODER_MAX]; // Invalid transitions
+    int32_t windowPosition [MCP23017_ENCODER_MAX];  // Position at the start of the velocity window
+    int32_t speed [MCP23017_ENCODER_MAX]; // Last velocity in quarter steps per second
+    uint32_t windowTime = 0;  // Start of the velocity window
+    uint16_t velocityWindow = MCP23017_ENCODER_VELOCITY_MS; // Velocity window in milliseconds
+    uint16_t pinMask = 0; // Pins used by the encoders
+    uint16_t lastState = 0; // Pin states at the last update
+
+    static void edgeIsr (int8_t pin, void *context);
+    void step (uint16_t state);
+    void updateVelocity();
+
+  public:
+    CSE_MCP23017_Encoder (CSE_MCP23017 *ioExpander);
+    int8_t attach (uint8_t pinA, uint8_t pinB);
+    uint8_t begin (bool interruptDriven = false);
+    void update (uint16_t flags, uint16_t capture, uint16_t gpio);
+    void update (const ioeEvent_t &event);
+    uint8_t poll();
+    int32_t read (uint8_t encoder);
+    void write (uint8_t encoder, int32_t value);
+    int32_t velocity (uint8_t encoder);
+    void setVelocityWindow (uint16_t window);
+    uint16_t errors (uint8_t encoder);
+};
+
+//============================================================================================//
+
+#endif
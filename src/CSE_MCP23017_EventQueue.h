@@ -0,0 +1,132 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_EVENTQUEUE_H
+#define CSE_MCP23017_EVENTQUEUE_H
+
+#include <stdint.h>
+
+//============================================================================================//
+
+#ifndef   MCP23017_EVENT_QUEUE_SIZE
+  #define   MCP23017_EVENT_QUEUE_SIZE   16U // Event queue length, must be a power of 2 and <= 128
+#endif
+
+static_assert (((MCP23017_EVENT_QUEUE_SIZE & (MCP23017_EVENT_QUEUE_SIZE - 1)) == 0) && (MCP23017_EVENT_QUEUE_SIZE <= 128),
+  "MCP23017_EVENT_QUEUE_SIZE must be a power of 2 and <= 128");
+
+//============================================================================================//
+// Typedefs
+
+typedef struct {  // An interrupt event from an IO expander
+  uint32_t timestamp; // Host micros() at the time of the host interrupt
+  uint8_t device; // Index of the IO expander object
+  int8_t pin; // Lowest flagged pin, -1 if no pin was flagged
+  uint16_t flags; // INTF of both ports, bits 0-7 = Port A, bits 8-15 = Port B
+  uint16_t capture; // INTCAP of both ports
+  uint16_t gpio;  // GPIO of both ports at the time of service
+  bool serviced;  // Set when the registers above have been read from the device
+} ioeEvent_t;
+
+//============================================================================================//
+/**
+ * @brief A single-producer, single-consumer ring of interrupt events. The producer is the host
+ * interrupt handler and the consumer is the main loop. No locks or interrupt masking are needed.
+ * The head is only written by the producer and the tail only by the consumer. The index stores
+ * use release ordering, and the index loads acquire ordering, so a slot is always fully written
+ * before it becomes visible to the other side. This also holds on multi-core hosts.
+ *
+ * Entries between the tail and the head belong to the consumer, which can modify them in place
+ * with `peek()` before removing them with `pop()`.
+ *
+ */
+class CSE_MCP23017_EventQueue {
+  private:
+    ioeEvent_t events [MCP23017_EVENT_QUEUE_SIZE];
+    uint8_t head = 0; // Next slot to write, producer only
+    uint8_t tail = 0; // Next slot to read, consumer only
+    volatile uint16_t dropCount = 0; // Events lost because the queue was full, producer only
+
+  public:
+    //--------------------------------------------------------------------------------------------//
+    /**
+     * @brief Adds an event to the queue. Must only be called from the producer.
+     *
+     * @param event The event to add.
+     * @return true The event was added.
+     * @return false The queue is full and the event was dropped.
+     */
+    bool push (const ioeEvent_t &event) {
+      uint8_t h = __atomic_load_n (&head, __ATOMIC_RELAXED);
+      uint8_t t = __atomic_load_n (&tail, __ATOMIC_ACQUIRE);
+
+      if (uint8_t (h - t) >= MCP23017_EVENT_QUEUE_SIZE) {
+        dropCount = dropCount + 1;
+        return false;
+      }
+
+      events [h & (MCP23017_EVENT_QUEUE_SIZE - 1)] = event;
+      __atomic_store_n (&head, uint8_t (h + 1), __ATOMIC_RELEASE);
+      return true;
+    }
+
+    //--------------------------------------------------------------------------------------------//
+    /**
+     * @brief Returns the oldest event without removing it. Must only be called from the consumer.
+     *
+     * @return ioeEvent_t* Pointer to the event, or `nullptr` if the queue is empty.
+     */
+    ioeEvent_t* peek() {
+      uint8_t t = __atomic_load_n (&tail, __ATOMIC_RELAXED);
+
+      if (t == __atomic_load_n (&head, __ATOMIC_ACQUIRE)) {
+        return nullptr;
+      }
+
+      return &events [t & (MCP23017_EVENT_QUEUE_SIZE - 1)];
+    }
+
+    //--------------------------------------------------------------------------------------------//
+    /**
+     * @brief Removes the oldest event. Must only be called from the consumer.
+     *
+     * @param event The removed event is copied here.
+     * @return true An event was removed.
+     * @return false The queue is empty.
+     */
+    bool pop (ioeEvent_t &event) {
+      ioeEvent_t *slot = peek();
+
+      if (slot == nullptr) {
+        return false;
+      }
+
+      event = *slot;
+      __atomic_store_n (&tail, uint8_t (tail + 1), __ATOMIC_RELEASE);
+      return true;
+    }
+
+    //--------------------------------------------------------------------------------------------//
+    /**
+     * @brief Returns the number of events in the queue. The value is a snapshot if called from
+     * the producer while the consumer is running, or vice versa.
+     *
+     * @return uint8_t The number of events.
+     */
+    uint8_t count() {
+      return uint8_t (__atomic_load_n (&head, __ATOMIC_ACQUIRE) - __atomic_load_n (&tail, __ATOMIC_ACQUIRE));
+    }
+
+    //--------------------------------------------------------------------------------------------//
+    /**
+     * @brief Returns the number of events dropped because the queue was full.
+     *
+     * @return uint16_t The drop count.
+     */
+    uint16_t dropped() {
+      return dropCount; // Diagnostic only, may tear on 8-bit hosts
+    }
+};
+
+//============================================================================================//
+
+#endif
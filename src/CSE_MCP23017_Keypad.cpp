@@ -0,0 +1,238 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017_Keypad.h"
+
+//============================================================================================//
+
+CSE_MCP23017_Keypad:: CSE_MCP23017_Keypad (CSE_MCP23017 *ioExpander) {
+  ioe = ioExpander;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Configures the ports of the IOE for the keypad and drives all the rows low.
+ *
+ * @param interruptDriven `true` to attach a change interrupt to the columns.
+ * @return uint8_t `MCP23017_RESP_OK` or the first error code.
+ */
+uint8_t CSE_MCP23017_Keypad:: begin (bool interruptDriven) {
+  useInterrupt = interruptDriven;
+  keys = 0;
+  pressed = 0;
+  released = 0;
+  ghost = false;
+
+  uint8_t response = ioe->portWrite (MCP23017_PORT_A, LOW);  // Latches stay 0, the direction selects the row
+
+  if (response == MCP23017_RESP_OK) {
+    response = ioe->portMode (MCP23017_PORT_B, INPUT_PULLUP);
+  }
+
+  if (response == MCP23017_RESP_OK) {
+    response = driveRows (0xFFU);
+  }
+
+  if (useInterrupt) {
+    for (uint8_t column = 0; (column < MCP23017_KEYPAD_COLUMNS) && (response == MCP23017_RESP_OK); column++) {
+      response = uint8_t (ioe->attachInterrupt (uint8_t (MCP23017_KEYPAD_ROWS + column), columnIsr, MCP23017_INT_CHANGE, this));
+    }
+  }
+
+  activity = true;  // Take the initial state on the first update
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+void CSE_MCP23017_Keypad:: columnIsr (int8_t pin, void *context) {
+  (void) pin;
+  static_cast <CSE_MCP23017_Keypad*> (context)->activity = true;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Drives the selected rows low and leaves the others floating, with one write to `IODIRA`.
+ *
+ * @param rows The rows to drive. Bit n = row n.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017_Keypad:: driveRows (uint8_t rows) {
+  uint8_t direction = uint8_t (~rows); // 1 = input
+  uint8_t response = ioe->write (MCP23017_REG_IODIRA, direction);
+
+  if (response == MCP23017_RESP_OK) {
+    ioe->regBank [MCP23017_REG_IODIRA] = direction;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Checks a key map for ghosting. A scan is ambiguous if two rows share two or more
+ * pressed columns.
+ *
+ * @param map The key map.
+ * @return true The map may contain ghost keys.
+ * @return false The map is unambiguous.
+ */
+bool CSE_MCP23017_Keypad:: isGhosted (uint64_t map) {
+  for (uint8_t row = 1; row < MCP23017_KEYPAD_ROWS; row++) {
+    uint8_t columns = uint8_t (map >> (row * MCP23017_KEYPAD_COLUMNS));
+
+    if ((columns & (columns - 1)) == 0) {
+      continue; // A row with fewer than two keys can not share two columns
+    }
+
+    for (uint8_t other = 0; other < row; other++) {
+      uint8_t common = columns & uint8_t (map >> (other * MCP23017_KEYPAD_COLUMNS));
+
+      if ((common & (common - 1)) != 0) {
+        return true;
+      }
+    }
+  }
+
+  return false;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Scans the whole matrix, one row at a time, and updates the key state. All the rows are
+ * driven low again at the end. If the scan is ghosted, the key state is kept as it was.
+ *
+ * @return uint8_t `MCP23017_RESP_OK` or the I2C error code. The state is not changed on error.
+ */
+uint8_t CSE_MCP23017_Keypad:: scan() {
+  uint64_t map = 0;
+  uint8_t response = MCP23017_RESP_OK;
+
+  for (uint8_t row = 0; row < MCP23017_KEYPAD_ROWS; row++) {
+    response = driveRows (uint8_t (1U << row));
+
+    if (response != MCP23017_RESP_OK) {
+      break;
+    }
+
+    uint8_t columns = ioe->read (MCP23017_REG_GPIOB);
+
+    if (ioe->readError()) {
+      ioe->readError (false);
+      response = MCP23017_ERROR_RF;
+      break;
+    }
+
+    map |= uint64_t (uint8_t (~columns)) << (row * MCP23017_KEYPAD_COLUMNS); // Pressed keys read low
+  }
+
+  uint8_t idleResponse = driveRows (0xFFU);
+  response = (response != MCP23017_RESP_OK) ? response : idleResponse;
+
+  pressed = 0;
+  released = 0;
+
+  if (response != MCP23017_RESP_OK) {
+    return response;
+  }
+
+  ghost = isGhosted (map);
+
+  if (!ghost) {
+    pressed = map & ~keys;
+    released = keys & ~map;
+    keys = map;
+  }
+
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Updates the key state, scanning the matrix only when needed. A full scan runs if a
+ * key was held at the last scan, or there was column activity. Call this periodically, at the
+ * debounce interval of the keypad.
+ *
+ * @return true Keys were pressed or released.
+ * @return false No change.
+ */
+bool CSE_MCP23017_Keypad:: update() {
+  pressed = 0;
+  released = 0;
+
+  if ((keys == 0) && (!activity)) {
+    if (useInterrupt) {
+      return false;
+    }
+
+    // All the rows are low between scans, so one read tells if any key is down.
+    uint8_t columns = ioe->read (MCP23017_REG_GPIOB);
+
+    if (ioe->readError()) {
+      ioe->readError (false);
+      return false;
+    }
+
+    if (columns == 0xFFU) {
+      return false;
+    }
+  }
+
+  activity = false;
+  scan();
+
+  return (pressed | released) != 0;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the keys held down at the last scan.
+ *
+ * @return uint64_t The key map. Bit n = key n.
+ */
+uint64_t CSE_MCP23017_Keypad:: state() {
+  return keys;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the keys pressed in the last update.
+ *
+ * @return uint64_t The key map. Bit n = key n.
+ */
+uint64_t CSE_MCP23017_Keypad:: pressedKeys() {
+  return pressed;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the keys released in the last update.
+ *
+ * @return uint64_t The key map. Bit n = key n.
+ */
+uint64_t CSE_MCP23017_Keypad:: releasedKeys() {
+  return released;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Checks if a key was held down at the last scan.
+ *
+ * @param key The key number, row * 8 + column.
+ * @return true The key is down.
+ * @return false The key is up, or the number is out of range.
+ */
+bool CSE_MCP23017_Keypad:: isPressed (uint8_t key) {
+  return (key < MCP23017_KEYPAD_KEYS) && ((keys >> key) & 0x1U);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns whether the last scan was ambiguous and ignored.
+ *
+ * @return true The last scan had possible ghost keys.
+ * @return false The last scan was valid.
+ */
+bool CSE_MCP23017_Keypad:: ghosted() {
+  return ghost;
+}
@@ -0,0 +1,61 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_KEYPAD_H
+#define CSE_MCP23017_KEYPAD_H
+
+#include "CSE_MCP23017.h"
+
+//============================================================================================//
+
+#define   MCP23017_KEYPAD_ROWS        8U  // Rows on port A
+#define   MCP23017_KEYPAD_COLUMNS     8U  // Columns on port B
+#define   MCP23017_KEYPAD_KEYS        64U
+
+//============================================================================================//
+/**
+ * @brief Scans a matrix keypad of up to 8 x 8 keys on a single IO expander. The rows are on
+ * port A and the columns on port B. The columns are pulled up. A row is driven low by switching
+ * only its pin to an output, with the output latch held at 0. The other rows are left floating,
+ * so two keys pressed in the same column never short two driven rows. A full scan takes one
+ * direction write and one column read per row.
+ *
+ * Key n is at row n / 8 and column n % 8. The keys are reported as 64-bit maps. Without diodes,
+ * three keys on the corners of a rectangle make the fourth one appear pressed. Such scans are
+ * reported by `ghosted()` and do not change the key state.
+ *
+ * Between scans, all the rows are driven low, so any pressed key pulls a column low. With
+ * `begin (true)`, a change interrupt is attached to the columns, and full scans only run after a
+ * key interrupt or while a key is held. This requires `configInterrupt()` or `setPolling()` on
+ * the IOE before `begin()`, and `dispatchInterrupt()` or `pollChanges()` in the main loop.
+ * Without interrupts, `update()` reads the columns once, and only scans if a column is low.
+ *
+ */
+class CSE_MCP23017_Keypad {
+  private:
+    CSE_MCP23017 *ioe;  // The IO expander the keypad is on
+    bool useInterrupt = false;  // Full scans are triggered by column interrupts
+    volatile bool activity = false; // Set by a column interrupt
+    bool ghost = false; // The last scan was ambiguous
+    uint64_t keys = 0;  // Keys held down
+    uint64_t pressed = 0; // Keys pressed in the last update
+    uint64_t released = 0;  // Keys released in the last update
+
+    static void columnIsr (int8_t pin, void *context);
+    uint8_t driveRows (uint8_t rows);
+    static bool isGhosted (uint64_t map);
+
+  public:
+    CSE_MCP23017_Keypad (CSE_MCP23017 *ioExpander);
+    uint8_t begin (bool interruptDriven = false);
+    bool update();
+    uint8_t scan();
+    uint64_t state();
+    uint64_t pressedKeys();
+    uint64_t releasedKeys();
+    bool isPressed (uint8_t key);
+    bool ghosted();
+};
+
+//============================================================================================//
+
+#endif
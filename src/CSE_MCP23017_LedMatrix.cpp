@@ -0,0 +1,208 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017_LedMatrix.h"
+
+//============================================================================================//
+
+CSE_MCP23017_LedMatrix:: CSE_MCP23017_LedMatrix (CSE_MCP23017 *ioExpander) {
+  ioe = ioExpander;
+  setBrightness (MCP23017_LED_LEVELS);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets all the pins as outputs and blanks the matrix.
+ *
+ * @param rowActive The level that selects a row. `LOW` for rows that sink the current.
+ * @param columnActive The level that lights an LED in the selected row.
+ * @return uint8_t The I2C response code.
+ */
+uint8_t CSE_MCP23017_LedMatrix:: begin (uint8_t rowActive, uint8_t columnActive) {
+  rowLevel = rowActive;
+  columnLevel = columnActive;
+  row = 0;
+  slotTick = 0;
+  lastWord = blankWord();
+
+  // Blank the latches first, so that nothing lights up when the pins become outputs.
+  uint8_t response = ioe->writeWord (lastWord);
+
+  if (response == MCP23017_RESP_OK) {
+    response = ioe->modeWord (0xFFFFU, 0x0000U);
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+uint16_t CSE_MCP23017_LedMatrix:: rowWord (uint8_t rowIndex, uint8_t columns) {
+  uint8_t select = (rowLevel == HIGH) ? uint8_t (1U << rowIndex) : uint8_t (~(1U << rowIndex));
+  uint8_t data = (columnLevel == HIGH) ? columns : uint8_t (~columns);
+
+  return uint16_t (select) | (uint16_t (data) << 8);
+}
+
+uint16_t CSE_MCP23017_LedMatrix:: blankWord() {
+  uint8_t select = (rowLevel == HIGH) ? 0x00U : 0xFFU;
+  uint8_t data = (columnLevel == HIGH) ? 0x00U : 0xFFU;
+
+  return uint16_t (select) | (uint16_t (data) << 8);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Advances the refresh by one tick. At the start of a row slot, the row is shown. When
+ * the brightness of the row has elapsed, it is blanked. The latches are only written when their
+ * value changes. If the last row was lit to the end of its slot, the columns are blanked with
+ * an extra write before the next row is selected.
+ *
+ * @return uint8_t The I2C response code. `MCP23017_RESP_OK` if nothing was written.
+ */
+uint8_t CSE_MCP23017_LedMatrix:: tick() {
+  if ((row == 0) && (slotTick == 0) && swapPending) {
+    front ^= 1;
+    swapPending = false;
+  }
+
+  uint8_t columns = uint8_t (frames [front] >> (row * MCP23017_LED_COLUMNS));
+  uint16_t word = (slotTick < brightness [row]) ? rowWord (row, columns) : blankWord();
+  uint8_t response = MCP23017_RESP_OK;
+
+  // A word write updates OLATA before OLATB. So when another row is selected while the columns
+  // are lit, the columns are blanked first, and the new row never shows the data of the old one.
+  uint16_t blank = blankWord();
+
+  if ((((word ^ lastWord) & 0x00FFU) != 0) && (((word ^ blank) & 0x00FFU) != 0) && (((lastWord ^ blank) & 0xFF00U) != 0)) {
+    uint8_t data = uint8_t (blank >> 8);
+    response = ioe->write (MCP23017_REG_OLATB, data);
+
+    if (response == MCP23017_RESP_OK) {
+      ioe->regBank [MCP23017_REG_OLATB] = data;
+      lastWord = (lastWord & 0x00FFU) | (blank & 0xFF00U);
+    }
+  }
+
+  if ((word != lastWord) && (response == MCP23017_RESP_OK)) {
+    response = ioe->writeWord (word);
+
+    if (response == MCP23017_RESP_OK) {
+      lastWord = word;
+    }
+  }
+
+  if (++slotTick >= MCP23017_LED_LEVELS) {
+    slotTick = 0;
+    row = (row + 1) % MCP23017_LED_ROWS;
+  }
+
+  return response;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets a pixel in the back buffer.
+ *
+ * @param rowIndex The row, 0-7.
+ * @param column The column, 0-7.
+ * @param on `true` to light the pixel.
+ */
+void CSE_MCP23017_LedMatrix:: setPixel (uint8_t rowIndex, uint8_t column, bool on) {
+  if ((rowIndex < MCP23017_LED_ROWS) && (column < MCP23017_LED_COLUMNS)) {
+    uint64_t bit = uint64_t (1) << ((rowIndex * MCP23017_LED_COLUMNS) + column);
+    uint8_t back = front ^ 1;
+    frames [back] = on ? (frames [back] | bit) : (frames [back] & ~bit);
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets all the pixels of a row in the back buffer.
+ *
+ * @param rowIndex The row, 0-7.
+ * @param columns The pixels. Bit n = column n.
+ */
+void CSE_MCP23017_LedMatrix:: setRow (uint8_t rowIndex, uint8_t columns) {
+  if (rowIndex < MCP23017_LED_ROWS) {
+    uint8_t shift = rowIndex * MCP23017_LED_COLUMNS;
+    uint8_t back = front ^ 1;
+    frames [back] = (frames [back] & ~(uint64_t (0xFFU) << shift)) | (uint64_t (columns) << shift);
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the whole back buffer.
+ *
+ * @param frame The pixels. Row n is in byte n.
+ */
+void CSE_MCP23017_LedMatrix:: setFrame (uint64_t frame) {
+  frames [front ^ 1] = frame;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Clears the back buffer.
+ *
+ */
+void CSE_MCP23017_LedMatrix:: clear() {
+  frames [front ^ 1] = 0;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the frame being shown.
+ *
+ * @return uint64_t The pixels. Row n is in byte n.
+ */
+uint64_t CSE_MCP23017_LedMatrix:: getFrame() {
+  return frames [front];
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Shows the back buffer from the start of the next refresh. The back buffer must not be
+ * changed until `ready()` returns `true`. After the swap, the back buffer holds the old frame,
+ * so copy the new frame with `setFrame (getFrame())` before drawing on top of it.
+ *
+ */
+void CSE_MCP23017_LedMatrix:: show() {
+  swapPending = true;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns whether the back buffer can be drawn on.
+ *
+ * @return true The last frame has been swapped in.
+ * @return false A swap is pending.
+ */
+bool CSE_MCP23017_LedMatrix:: ready() {
+  return !swapPending;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the brightness of a row. The row is lit for this many ticks of its slot.
+ *
+ * @param rowIndex The row, 0-7.
+ * @param level 0 (off) to `MCP23017_LED_LEVELS` (full). Larger values are clamped.
+ */
+void CSE_MCP23017_LedMatrix:: setBrightness (uint8_t rowIndex, uint8_t level) {
+  if (rowIndex < MCP23017_LED_ROWS) {
+    brightness [rowIndex] = (level > MCP23017_LED_LEVELS) ? MCP23017_LED_LEVELS : level;
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets the brightness of all the rows.
+ *
+ * @param level 0 (off) to `MCP23017_LED_LEVELS` (full). Larger values are clamped.
+ */
+void CSE_MCP23017_LedMatrix:: setBrightness (uint8_t level) {
+  for (uint8_t i = 0; i < MCP23017_LED_ROWS; i++) {
+    setBrightness (i, level);
+  }
+}
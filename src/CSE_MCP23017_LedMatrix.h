@@ -0,0 +1,70 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_LEDMATRIX_H
+#define CSE_MCP23017_LEDMATRIX_H
+
+#include "CSE_MCP23017.h"
+
+//============================================================================================//
+
+#define   MCP23017_LED_ROWS           8U  // Row select lines on port A
+#define   MCP23017_LED_COLUMNS        8U  // Column data lines on port B
+
+#ifndef   MCP23017_LED_LEVELS
+  #define   MCP23017_LED_LEVELS       8U  // Brightness levels per row, ticks per row slot
+#endif
+
+static_assert ((MCP23017_LED_LEVELS >= 1) && (MCP23017_LED_LEVELS <= 255), "MCP23017_LED_LEVELS must be 1 to 255");
+
+//============================================================================================//
+/**
+ * @brief Refreshes a multiplexed 8 x 8 LED matrix on a single IO expander. The row select lines
+ * are on port A and the column lines on port B. Each row is shown with one write to `OLATA` and
+ * `OLATB` in a single transaction. The two latches still update one after the other, so if the
+ * columns of the last row are lit, they are blanked with a write to `OLATB` before the next row
+ * is selected. This only happens with rows at full brightness.
+ *
+ * Frames are double-buffered. Draw to the back buffer with `setPixel()`, `setRow()` or
+ * `setFrame()`, and call `show()`. The buffers are swapped when the refresh wraps around to the
+ * first row, so a frame is never shown partly.
+ *
+ * Each row slot lasts `MCP23017_LED_LEVELS` ticks. A row with brightness n is lit for the first
+ * n ticks and blanked for the rest. Ticks without a change do not access the bus. Call `tick()`
+ * at a steady rate, from the main loop or a timer, at `fps x 8 x MCP23017_LED_LEVELS` per second.
+ * The IOE must be in the default BANK = 0, sequential mode for the write to be a single one.
+ *
+ */
+class CSE_MCP23017_LedMatrix {
+  private:
+    CSE_MCP23017 *ioe;  // The IO expander the matrix is on
+    uint64_t frames [2] = {0, 0}; // Front and back buffers, row n in byte n
+    volatile uint8_t front = 0; // Index of the buffer being shown
+    volatile bool swapPending = false;  // Swap the buffers at the start of the next refresh
+    uint8_t brightness [MCP23017_LED_ROWS]; // Lit ticks of each row slot
+    uint8_t rowLevel = LOW; // Level that selects a row
+    uint8_t columnLevel = HIGH; // Level that lights a column
+    uint8_t row = 0;  // Row being shown
+    uint8_t slotTick = 0; // Tick within the row slot
+    uint16_t lastWord = 0;  // Last value written to the latches
+
+    uint16_t rowWord (uint8_t rowIndex, uint8_t columns);
+    uint16_t blankWord();
+
+  public:
+    CSE_MCP23017_LedMatrix (CSE_MCP23017 *ioExpander);
+    uint8_t begin (uint8_t rowActive = LOW, uint8_t columnActive = HIGH);
+    uint8_t tick();
+    void setPixel (uint8_t rowIndex, uint8_t column, bool on);
+    void setRow (uint8_t rowIndex, uint8_t columns);
+    void setFrame (uint64_t frame);
+    void clear();
+    uint64_t getFrame();
+    void show();
+    bool ready();
+    void setBrightness (uint8_t rowIndex, uint8_t level);
+    void setBrightness (uint8_t level);
+};
+
+//============================================================================================//
+
+#endif
@@ -0,0 +1,240 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017.h"
+#include "CSE_MCP23017_SPI.h"
+
+//============================================================================================//
+
+CSE_MCP23017_SPI:: CSE_MCP23017_SPI (SPIClass *spiPort, uint8_t chipSelect, uint32_t clock) : settings (clock, MSBFIRST, SPI_MODE0) {
+  spi = spiPort;
+  csPin = chipSelect;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+void CSE_MCP23017_SPI:: select() {
+  spi->beginTransaction (settings);
+  ::digitalWrite (csPin, LOW);
+}
+
+void CSE_MCP23017_SPI:: deselect() {
+  ::digitalWrite (csPin, HIGH);
+  spi->endTransaction();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the SPI control byte for a device. The hardware address is the lower three
+ * bits of the I2C style device address.
+ *
+ * @param address The device address.
+ * @param read `true` for a read, `false` for a write.
+ * @return uint8_t The control byte.
+ */
+uint8_t CSE_MCP23017_SPI:: opcode (uint8_t address, bool read) {
+  return MCP23S17_OPCODE | ((address & 0x07U) << 1) | (read ? MCP23S17_OPCODE_READ : 0);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Initializes the SPI controller and the chip select pin, and enables the hardware address
+ * pins of the device. The controller is started with `SPIClass::begin()`, which is harmless if
+ * the sketch has already started it. Until HAEN is set, the device only responds to hardware
+ * address 0. Due to a silicon errata, a device with A2 = 1 may respond to hardware address 4
+ * instead, so IOCON is written at both. The device is expected to be just reset, in the BANK = 0
+ * mode. The device is then read back with `probe()`.
+ *
+ * @param address The device address.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_OF` if there is no SPI controller, or
+ * `MCP23017_ERROR_RF` if the device does not respond.
+ */
+uint8_t CSE_MCP23017_SPI:: begin (uint8_t address) {
+  if (spi == NULL) {
+    return MCP23017_ERROR_OF;
+  }
+
+  spi->begin();
+  ::pinMode (csPin, OUTPUT);
+  ::digitalWrite (csPin, HIGH);
+
+  // Written without verification, because only one of the two addresses is the device.
+  bool verify = verifyWrites;
+  verifyWrites = false;
+
+  uint8_t iocon = ioconBits();
+  write (0x00, MCP23017_REG_IOCON, &iocon, 1);
+  write (0x04, MCP23017_REG_IOCON, &iocon, 1);
+
+  verifyWrites = verify;
+  return probe (address);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the IOCON bits needed by the SPI transport.
+ *
+ * @return uint8_t The HAEN bit.
+ */
+uint8_t CSE_MCP23017_SPI:: ioconBits() {
+  return (1U << MCP23017_BIT_HAEN);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets whether every write is read back and compared. This costs one read transaction per
+ * write. Only enable it when writing registers that read back as written. GPIO, INTF, INTCAP
+ * and the unimplemented bit 0 of IOCON read back differently, and would report failures.
+ *
+ * @param enable `true` to verify the writes, `false` to not.
+ */
+void CSE_MCP23017_SPI:: setWriteVerify (bool enable) {
+  verifyWrites = enable;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief SPI has no acknowledge, so the presence is checked by reading IOCON. HAEN must read
+ * back as set, and the unimplemented bit 0 as 0, which is not the case for a floating or pulled
+ * MISO line.
+ *
+ * @param address The device address.
+ * @return uint8_t `MCP23017_RESP_OK` or `MCP23017_ERROR_RF`.
+ */
+uint8_t CSE_MCP23017_SPI:: probe (uint8_t address) {
+  uint8_t iocon = 0;
+
+  if (writeThenRead (address, MCP23017_REG_IOCON, &iocon, 1) != MCP23017_RESP_OK) {
+    return MCP23017_ERROR_RF;
+  }
+
+  if (((iocon & ioconBits()) == ioconBits()) && ((iocon & 0x01U) == 0)) {
+    return MCP23017_RESP_OK;
+  }
+
+  return MCP23017_ERROR_RF;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes the register address followed by the data in a single transaction. If write
+ * verification is enabled, the bytes are read back in a second transaction.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The bytes to write.
+ * @param length The number of bytes to write.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_OOR` if the length or buffer is invalid,
+ * `MCP23017_ERROR_OF` if there is no SPI controller, or `MCP23017_ERROR_WF` if the read back
+ * does not match.
+ */
+uint8_t CSE_MCP23017_SPI:: write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) {
+  if (spi == NULL) {
+    return MCP23017_ERROR_OF;
+  }
+
+  if ((length > MCP23S17_MAX_LENGTH) || ((data == NULL) && (length != 0))) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  parkedRegister = regAddress;
+
+  if (length == 0) {
+    return MCP23017_RESP_OK;  // Every SPI transaction carries the register address anyway
+  }
+
+  select();
+  spi->transfer (opcode (address, false));
+  spi->transfer (regAddress);
+
+  for (size_t i = 0; i < length; i++) {
+    spi->transfer (data [i]);
+  }
+
+  deselect();
+
+  if (verifyWrites) {
+    select();
+    spi->transfer (opcode (address, true));
+    spi->transfer (regAddress);
+
+    bool matched = true;
+
+    for (size_t i = 0; i < length; i++) {
+      matched = (spi->transfer (0x00) == data [i]) && matched;
+    }
+
+    deselect();
+
+    if (!matched) {
+      return MCP23017_ERROR_WF;
+    }
+  }
+
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes the register address and reads the data in a single transaction. A missing
+ * device reads as the idle level of MISO, which can not be told apart from data here. Use
+ * `probe()` for that.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The buffer for the bytes read.
+ * @param length The number of bytes to read.
+ * @return uint8_t `MCP23017_RESP_OK`, `MCP23017_ERROR_OOR` if the length or buffer is invalid,
+ * or `MCP23017_ERROR_OF` if there is no SPI controller.
+ */
+uint8_t CSE_MCP23017_SPI:: writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) {
+  if (spi == NULL) {
+    return MCP23017_ERROR_OF;
+  }
+
+  if ((length > MCP23S17_MAX_LENGTH) || ((data == NULL) && (length != 0))) {
+    return MCP23017_ERROR_OOR;
+  }
+
+  parkedRegister = regAddress;
+
+  select();
+  spi->transfer (opcode (address, true));
+  spi->transfer (regAddress);
+
+  for (size_t i = 0; i < length; i++) {
+    data [i] = spi->transfer (0x00);
+  }
+
+  deselect();
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads from the register of the last transaction. SPI transactions always start with
+ * the register address, so this re-sends it. This matches the I2C behaviour in the byte mode,
+ * which is how `CSE_MCP23017::sample()` uses it.
+ *
+ * @param address The device address.
+ * @param data The buffer for the bytes read.
+ * @param length The number of bytes to read.
+ * @return size_t The number of bytes read, 0 on failure.
+ */
+size_t CSE_MCP23017_SPI:: readN (uint8_t address, uint8_t *data, size_t length) {
+  if (writeThenRead (address, parkedRegister, data, length) != MCP23017_RESP_OK) {
+    return 0;
+  }
+
+  return length;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the maximum number of data bytes in a single transaction.
+ *
+ * @return size_t The maximum length.
+ */
+size_t CSE_MCP23017_SPI:: maxLength() {
+  return MCP23S17_MAX_LENGTH;
+}
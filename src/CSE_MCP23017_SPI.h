@@ -0,0 +1,56 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_SPI_H
+#define CSE_MCP23017_SPI_H
+
+#include <Arduino.h>
+#include <SPI.h>
+#include "CSE_MCP23017_Transport.h"
+
+//============================================================================================//
+
+#define   MCP23S17_OPCODE             0x40U // SPI control byte, 0 1 0 0 A2 A1 A0 R/W
+#define   MCP23S17_OPCODE_READ        0x01U // R/W bit of the control byte
+#define   MCP23S17_SPI_CLOCK          10000000UL  // Max. SPI clock of the MCP23S17
+#define   MCP23S17_MAX_LENGTH         0xFFFFU // Max. data bytes per transaction, SPI has no buffer limit
+
+//============================================================================================//
+/**
+ * @brief The SPI transport for the MCP23S17. The register set is the same as the MCP23017, so
+ * every API of `CSE_MCP23017` works unchanged on top of it. Pass a pointer to this to the
+ * `CSE_MCP23017` constructor, with the hardware address (0x20 to 0x27) as the device address.
+ *
+ * Several MCP23S17s can share a chip select line and be told apart by their A2..A0 pins. This
+ * requires the HAEN bit of IOCON, which is set by `CSE_MCP23017::begin()` through this transport.
+ *
+ * SPI has no acknowledge, so a missing device is only detected by reading it back. `begin()` and
+ * `probe()` do this. Writes can be verified the same way with `setWriteVerify()`.
+ *
+ */
+class CSE_MCP23017_SPI final : public CSE_MCP23017_Transport {
+  private:
+    SPIClass *spi;  // The SPI controller
+    uint8_t csPin;  // The chip select pin
+    SPISettings settings; // Clock, bit order and mode
+    uint8_t parkedRegister = 0; // Register address of the last transaction, used by readN()
+    bool verifyWrites = false;  // Read back every write
+
+    void select();
+    void deselect();
+    uint8_t opcode (uint8_t address, bool read);
+
+  public:
+    CSE_MCP23017_SPI (SPIClass *spiPort, uint8_t chipSelect, uint32_t clock = MCP23S17_SPI_CLOCK);
+    uint8_t begin (uint8_t address) override;
+    uint8_t ioconBits() override;
+    void setWriteVerify (bool enable);
+    uint8_t probe (uint8_t address) override;
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override;
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override;
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override;
+    size_t maxLength() override;
+};
+
+//============================================================================================//
+
+#endif
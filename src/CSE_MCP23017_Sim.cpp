@@ -0,0 +1,405 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017.h"
+#include "CSE_MCP23017_Sim.h"
+
+//============================================================================================//
+
+CSE_MCP23017_Sim:: CSE_MCP23017_Sim (uint8_t address) {
+  deviceAddress = address;
+  reset();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Puts the model in the power-on reset state. The external input levels are kept.
+ *
+ */
+void CSE_MCP23017_Sim:: reset() {
+  for (uint8_t i = 0; i < MCP23017_SIM_REGCOUNT; i++) {
+    reg [i] = 0;
+  }
+
+  reg [MCP23017_REG_IODIRA] = 0xFF;
+  reg [MCP23017_REG_IODIRB] = 0xFF;
+  pointer = 0;
+  outputActive [0] = false;
+  outputActive [1] = false;
+  lastGpio = gpioValue();
+}
+
+//============================================================================================//
+/**
+ * @brief Drives an input pin from outside. The level only shows up in GPIO if the pin is an input.
+ *
+ * @param pin The pin. Can be 0-15.
+ * @param level `HIGH` or `LOW`.
+ */
+void CSE_MCP23017_Sim:: setInput (uint8_t pin, uint8_t level) {
+  if (pin < MCP23017_PINCOUNT) {
+    inputDriven |= (1U << pin);
+    inputLevel = (level == LOW) ? (inputLevel & ~(1U << pin)) : (inputLevel | (1U << pin));
+    evaluate();
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Drives all 16 pins from outside at once. The interrupt logic sees a single change.
+ *
+ * @param levels The levels. Bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+void CSE_MCP23017_Sim:: setInputs (uint16_t levels) {
+  inputDriven = 0xFFFFU;
+  inputLevel = levels;
+  evaluate();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Stops driving a pin. A floating input reads HIGH if its pull-up is enabled, and LOW
+ * otherwise.
+ *
+ * @param pin The pin. Can be 0-15.
+ */
+void CSE_MCP23017_Sim:: releaseInput (uint8_t pin) {
+  if (pin < MCP23017_PINCOUNT) {
+    inputDriven &= ~(1U << pin);
+    evaluate();
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the levels of the output pins. Input pins read as 0.
+ *
+ * @return uint16_t The output levels. Bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+uint16_t CSE_MCP23017_Sim:: outputs() {
+  uint16_t latch = uint16_t (reg [MCP23017_REG_OLATA]) | (uint16_t (reg [MCP23017_REG_OLATB]) << 8);
+  uint16_t direction = uint16_t (reg [MCP23017_REG_IODIRA]) | (uint16_t (reg [MCP23017_REG_IODIRB]) << 8);
+  return latch & ~direction;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads a register without any side effects.
+ *
+ * @param regIndex The register address in the BANK = 0 layout.
+ * @return uint8_t The register value.
+ */
+uint8_t CSE_MCP23017_Sim:: peek (uint8_t regIndex) {
+  if (regIndex == MCP23017_REG_GPIOA) {
+    return uint8_t (gpioValue());
+  }
+
+  if (regIndex == MCP23017_REG_GPIOB) {
+    return uint8_t (gpioValue() >> 8);
+  }
+
+  return (regIndex < MCP23017_SIM_REGCOUNT) ? reg [regIndex] : 0;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes a register directly, bypassing the bus and the read-only protection. Use this to
+ * set up a state for a test.
+ *
+ * @param regIndex The register address in the BANK = 0 layout.
+ * @param value The value.
+ */
+void CSE_MCP23017_Sim:: poke (uint8_t regIndex, uint8_t value) {
+  if (regIndex < MCP23017_SIM_REGCOUNT) {
+    reg [regIndex] = value;
+
+    if ((regIndex == MCP23017_REG_IOCON) || (regIndex == MCP23017_REG_IOCON_)) {
+      reg [MCP23017_REG_IOCON] = value;
+      reg [MCP23017_REG_IOCON_] = value;
+    }
+
+    updateOutputs();
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the electrical level of an interrupt output. An open-drain output that is not
+ * active is assumed to be pulled up.
+ *
+ * @param port `MCP23017_PORT_A` for INTA or `MCP23017_PORT_B` for INTB.
+ * @return uint8_t `HIGH` or `LOW`.
+ */
+uint8_t CSE_MCP23017_Sim:: interruptOutput (uint8_t port) {
+  uint8_t iocon = reg [MCP23017_REG_IOCON];
+  bool active = outputActive [port & 0x1U];
+
+  if (iocon & (1U << MCP23017_BIT_ODR)) {
+    return active ? LOW : HIGH;
+  }
+
+  bool activeHigh = iocon & (1U << MCP23017_BIT_INTPOL);
+  return (active == activeHigh) ? HIGH : LOW;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Sets a handler that is called every time an interrupt output becomes active. This can
+ * be the host interrupt handler that `CSE_MCP23017` attached, to run the interrupt path without
+ * a host pin.
+ *
+ * @param port `MCP23017_PORT_A` for INTA or `MCP23017_PORT_B` for INTB.
+ * @param handler The handler, or `NULL`.
+ */
+void CSE_MCP23017_Sim:: attachOutput (uint8_t port, void (*handler)(void)) {
+  outputHandler [port & 0x1U] = handler;
+}
+
+//============================================================================================//
+/**
+ * @brief Maps a device register address in the current bank layout to the BANK = 0 layout.
+ *
+ * @param regAddress The device register address.
+ * @return int The register index, or -1 if the address is not implemented.
+ */
+int CSE_MCP23017_Sim:: registerIndex (uint8_t regAddress) {
+  if ((reg [MCP23017_REG_IOCON] & (1U << MCP23017_BIT_BANK)) == 0) {
+    return (regAddress < MCP23017_SIM_REGCOUNT) ? int (regAddress) : -1;
+  }
+
+  if (regAddress <= 0x0AU) {
+    return int (regAddress * 2);
+  }
+
+  if ((regAddress >= 0x10U) && (regAddress <= 0x1AU)) {
+    return int (((regAddress - 0x10U) * 2) + 1);
+  }
+
+  return -1;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Moves the address pointer after a byte is transferred. In the sequential mode, the
+ * pointer increments and wraps within the register set (BANK = 0) or the port group (BANK = 1).
+ * In the byte mode, it toggles within the A/B pair (BANK = 0) or stays (BANK = 1).
+ *
+ */
+void CSE_MCP23017_Sim:: advancePointer() {
+  uint8_t iocon = reg [MCP23017_REG_IOCON];
+  bool bankGroup = iocon & (1U << MCP23017_BIT_BANK);
+
+  if (iocon & (1U << MCP23017_BIT_SEQOP)) {
+    if (!bankGroup) {
+      pointer ^= 0x1U;
+    }
+    return;
+  }
+
+  if (!bankGroup) {
+    pointer = (pointer + 1) % MCP23017_SIM_REGCOUNT;
+  }
+  else {
+    uint8_t groupBase = pointer & 0x10U;
+    pointer = ((pointer & 0x0FU) >= 0x0AU) ? groupBase : (pointer + 1);
+  }
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads the register at the address pointer, with the side effects of the device. Reading
+ * INTCAP or GPIO clears the interrupt of the port.
+ *
+ * @return uint8_t The register value. Unimplemented addresses read as 0.
+ */
+uint8_t CSE_MCP23017_Sim:: readRegister() {
+  int index = registerIndex (pointer);
+  uint8_t value = 0;
+
+  if (index >= 0) {
+    value = peek (uint8_t (index));
+
+    if ((index == MCP23017_REG_INTCAPA) || (index == MCP23017_REG_INTCAPB) ||
+        (index == MCP23017_REG_GPIOA) || (index == MCP23017_REG_GPIOB)) {
+      clearInterrupt (uint8_t (index) & 0x1U);
+    }
+  }
+
+  advancePointer();
+  return value;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes the register at the address pointer, with the side effects of the device.
+ * Writing GPIO writes OLAT. INTF and INTCAP are read-only.
+ *
+ * @param data The value.
+ */
+void CSE_MCP23017_Sim:: writeRegister (uint8_t data) {
+  int index = registerIndex (pointer);
+  advancePointer();
+
+  if ((index < 0) || ((index >= int (MCP23017_REG_INTFA)) && (index <= int (MCP23017_REG_INTCAPB)))) {
+    return;
+  }
+
+  if ((index == MCP23017_REG_GPIOA) || (index == MCP23017_REG_GPIOB)) {
+    index += (MCP23017_REG_OLATA - MCP23017_REG_GPIOA);
+  }
+
+  if ((index == MCP23017_REG_IOCON) || (index == MCP23017_REG_IOCON_)) {
+    reg [MCP23017_REG_IOCON] = data;
+    reg [MCP23017_REG_IOCON_] = data;
+  }
+  else {
+    reg [index] = data;
+  }
+
+  evaluate();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Computes the value of the GPIO registers. Outputs read their latch. Inputs read the
+ * external level, or the pull-up if floating, inverted by IPOL.
+ *
+ * @return uint16_t The GPIO value. Bits 0-7 = Port A, bits 8-15 = Port B.
+ */
+uint16_t CSE_MCP23017_Sim:: gpioValue() {
+  uint16_t direction = uint16_t (reg [MCP23017_REG_IODIRA]) | (uint16_t (reg [MCP23017_REG_IODIRB]) << 8);
+  uint16_t latch = uint16_t (reg [MCP23017_REG_OLATA]) | (uint16_t (reg [MCP23017_REG_OLATB]) << 8);
+  uint16_t pullup = uint16_t (reg [MCP23017_REG_GPPUA]) | (uint16_t (reg [MCP23017_REG_GPPUB]) << 8);
+  uint16_t polarity = uint16_t (reg [MCP23017_REG_IPOLA]) | (uint16_t (reg [MCP23017_REG_IPOLB]) << 8);
+
+  uint16_t input = (inputLevel & inputDriven) | (pullup & ~inputDriven);
+  return ((input ^ polarity) & direction) | (latch & ~direction);
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Clears the interrupt of a port, then re-evaluates it. A compare mode pin that still
+ * differs from DEFVAL raises the interrupt again right away.
+ *
+ * @param port 0 for Port A, 1 for Port B.
+ */
+void CSE_MCP23017_Sim:: clearInterrupt (uint8_t port) {
+  reg [MCP23017_REG_INTFA + port] = 0;
+  evaluate();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Runs the interrupt logic after any change of the pins or the registers. A pin raises
+ * the interrupt if it is enabled in GPINTEN and either changed since the last evaluation
+ * (INTCON = 0) or differs from DEFVAL (INTCON = 1). INTCAP is only latched if the port has no
+ * pending interrupt. Pins that interrupt while one is pending are added to INTF.
+ *
+ */
+void CSE_MCP23017_Sim:: evaluate() {
+  uint16_t gpio = gpioValue();
+
+  for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+    uint8_t portGpio = uint8_t (gpio >> (8 * port));
+    uint8_t portLast = uint8_t (lastGpio >> (8 * port));
+    uint8_t enable = reg [MCP23017_REG_GPINTENA + port] & reg [MCP23017_REG_IODIRA + port];
+    uint8_t control = reg [MCP23017_REG_INTCONA + port];
+
+    uint8_t changed = (portGpio ^ portLast) & (~control);
+    uint8_t compared = (portGpio ^ reg [MCP23017_REG_DEFVALA + port]) & control;
+    uint8_t flags = (changed | compared) & enable;
+
+    if (flags != 0) {
+      if (reg [MCP23017_REG_INTFA + port] == 0) {
+        reg [MCP23017_REG_INTCAPA + port] = portGpio;
+      }
+
+      reg [MCP23017_REG_INTFA + port] |= flags;
+    }
+  }
+
+  lastGpio = gpio;
+  updateOutputs();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Updates the INTA and INTB outputs from the flags, and calls the output handlers on
+ * each active edge. With MIRROR, both outputs follow the flags of both ports.
+ *
+ */
+void CSE_MCP23017_Sim:: updateOutputs() {
+  bool portActive [2] = {(reg [MCP23017_REG_INTFA] != 0), (reg [MCP23017_REG_INTFB] != 0)};
+
+  if (reg [MCP23017_REG_IOCON] & (1U << MCP23017_BIT_MIRROR)) {
+    portActive [0] = portActive [0] || portActive [1];
+    portActive [1] = portActive [0];
+  }
+
+  for (uint8_t port = 0; port < MCP23017_PORTCOUNT; port++) {
+    bool wasActive = outputActive [port];
+    outputActive [port] = portActive [port];
+
+    if ((!wasActive) && portActive [port] && (outputHandler [port] != NULL)) {
+      outputHandler [port]();
+    }
+  }
+}
+
+//============================================================================================//
+/**
+ * @brief The model acknowledges its own address only.
+ *
+ * @param address The device address.
+ * @return uint8_t `MCP23017_RESP_OK`, or 2 (address NACK) as the Wire library would return.
+ */
+uint8_t CSE_MCP23017_Sim:: probe (uint8_t address) {
+  return (address == deviceAddress) ? MCP23017_RESP_OK : 2;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+uint8_t CSE_MCP23017_Sim:: write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) {
+  if (address != deviceAddress) {
+    return 2;
+  }
+
+  pointer = regAddress;
+
+  for (size_t i = 0; i < length; i++) {
+    writeRegister (data [i]);
+  }
+
+  return MCP23017_RESP_OK;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+uint8_t CSE_MCP23017_Sim:: writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) {
+  if (address != deviceAddress) {
+    return 2;
+  }
+
+  pointer = regAddress;
+  return (readN (address, data, length) == length) ? MCP23017_RESP_OK : MCP23017_ERROR_RF;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+size_t CSE_MCP23017_Sim:: readN (uint8_t address, uint8_t *data, size_t length) {
+  if (address != deviceAddress) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < length; i++) {
+    data [i] = readRegister();
+  }
+
+  return length;
+}
+
+//--------------------------------------------------------------------------------------------//
+
+size_t CSE_MCP23017_Sim:: maxLength() {
+  return MCP23017_SIM_MAX_LENGTH;
+}
@@ -0,0 +1,74 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_SIM_H
+#define CSE_MCP23017_SIM_H
+
+#include "CSE_MCP23017_Transport.h"
+
+//============================================================================================//
+
+#define   MCP23017_SIM_REGCOUNT       22U // Registers of the device
+#define   MCP23017_SIM_MAX_LENGTH     0xFFFFU // Max. data bytes per transaction, the model has no buffer limit
+
+//============================================================================================//
+/**
+ * @brief A behavioural model of the MCP23017 that plugs in as a transport. It needs no hardware
+ * and no bus, so the whole library can be run and measured on any host with an Arduino core or
+ * a stub of it. The model covers:
+ *
+ *  - All 22 registers, with the power-on reset values.
+ *  - The BANK = 0 and BANK = 1 address maps, and the SEQOP address pointer behaviour.
+ *  - IOCON at both of its addresses.
+ *  - Output latches, input polarity, pull-ups and external input levels.
+ *  - Interrupt-on-change (INTCON = 0) and compare with DEFVAL (INTCON = 1).
+ *  - INTF and INTCAP latching, cleared by reading INTCAP or GPIO. INTCAP holds the port state of
+ *    the first interrupt, and later interrupts are added to INTF. Compare mode interrupts
+ *    re-assert right after clearing while the pin differs from DEFVAL.
+ *  - The INTA and INTB outputs with MIRROR, INTPOL and ODR.
+ *
+ * The test code drives the input pins with `setInput()` and can watch the interrupt outputs with
+ * `interruptOutput()`, or have a handler called on each active edge with `attachOutput()`.
+ *
+ */
+class CSE_MCP23017_Sim final : public CSE_MCP23017_Transport {
+  private:
+    uint8_t deviceAddress;  // The address the model responds to
+    uint8_t reg [MCP23017_SIM_REGCOUNT];  // Registers in the BANK = 0 layout
+    uint8_t pointer = 0;  // Address pointer, in the current bank layout
+    uint16_t inputLevel = 0;  // Levels driven on the pins from outside
+    uint16_t inputDriven = 0; // Pins driven from outside, the rest float
+    uint16_t lastGpio = 0;  // GPIO value at the last evaluation, for interrupt-on-change
+    bool outputActive [2] = {false, false}; // State of the INTA and INTB outputs
+    void (*outputHandler [2])(void) = {NULL, NULL}; // Called on an active edge of INTA / INTB
+
+    int registerIndex (uint8_t regAddress);
+    void advancePointer();
+    uint8_t readRegister();
+    void writeRegister (uint8_t data);
+    uint16_t gpioValue();
+    void clearInterrupt (uint8_t port);
+    void evaluate();
+    void updateOutputs();
+
+  public:
+    CSE_MCP23017_Sim (uint8_t address = 0x20U);
+    void reset();
+    void setInput (uint8_t pin, uint8_t level);
+    void setInputs (uint16_t levels);
+    void releaseInput (uint8_t pin);
+    uint16_t outputs();
+    uint8_t peek (uint8_t regIndex);
+    void poke (uint8_t regIndex, uint8_t value);
+    uint8_t interruptOutput (uint8_t port);
+    void attachOutput (uint8_t port, void (*handler)(void));
+
+    uint8_t probe (uint8_t address) override;
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override;
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override;
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override;
+    size_t maxLength() override;
+};
+
+//============================================================================================//
+
+#endif
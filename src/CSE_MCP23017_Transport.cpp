@@ -0,0 +1,104 @@
+//============================================================================================//
+// Includes
+
+#include "CSE_MCP23017.h"
+
+//============================================================================================//
+
+CSE_MCP23017_TwoWire:: CSE_MCP23017_TwoWire (TwoWire *wirePort) {
+  wire = wirePort;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Checks the presence of a device by reading the ACK response to its address.
+ *
+ * @param address The device address.
+ * @return uint8_t The response from the Wire library.
+ */
+uint8_t CSE_MCP23017_TwoWire:: probe (uint8_t address) {
+  wire->beginTransmission (address);
+  return wire->endTransmission(); // Read ACK
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes the register address followed by the data in a single transaction.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The bytes to write.
+ * @param length The number of bytes to write.
+ * @return uint8_t The response from the Wire library.
+ */
+uint8_t CSE_MCP23017_TwoWire:: write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) {
+  wire->beginTransmission (address);
+  wire->write (regAddress);
+
+  if (length > 0) {
+    wire->write (data, length);
+  }
+
+  return wire->endTransmission();
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Writes the register address and then reads the data after a repeated START. The bus
+ * is not released between the two, so no other controller can access the device in between,
+ * and a STOP and START are saved on every read.
+ *
+ * @param address The device address.
+ * @param regAddress The absolute register address.
+ * @param data The buffer for the bytes read.
+ * @param length The number of bytes to read.
+ * @return uint8_t `MCP23017_RESP_OK`, the response from the Wire library, or `MCP23017_ERROR_RF`.
+ */
+uint8_t CSE_MCP23017_TwoWire:: writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) {
+  wire->beginTransmission (address);
+  wire->write (regAddress);
+  uint8_t response = wire->endTransmission (false); // Keep the bus for a repeated START
+
+  if (response != MCP23017_RESP_OK) {
+    return response;
+  }
+
+  return (readN (address, data, length) == length) ? MCP23017_RESP_OK : MCP23017_ERROR_RF;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Reads from the current address pointer of the device. If fewer bytes than requested
+ * are received, the received bytes are still saved, and the rest of the buffer is untouched.
+ *
+ * @param address The device address.
+ * @param data The buffer for the bytes read.
+ * @param length The number of bytes to read.
+ * @return size_t The number of bytes received.
+ */
+size_t CSE_MCP23017_TwoWire:: readN (uint8_t address, uint8_t *data, size_t length) {
+  wire->requestFrom (uint8_t (address), uint8_t (length), uint8_t (true)); // Address, Quantity and Bus release
+
+  size_t count = 0;
+
+  while (wire->available() > 0) {
+    uint8_t byte = uint8_t (wire->read());
+
+    if (count < length) {
+      data [count++] = byte;
+    }
+  }
+
+  return count;
+}
+
+//--------------------------------------------------------------------------------------------//
+/**
+ * @brief Returns the maximum number of data bytes in a single transaction. One byte of the
+ * Wire buffer is used for the register address.
+ *
+ * @return size_t The maximum length.
+ */
+size_t CSE_MCP23017_TwoWire:: maxLength() {
+  return MCP23017_WIRE_BUFFER_SIZE - 1;
+}
@@ -0,0 +1,116 @@
+//============================================================================================//
+
+#ifndef CSE_MCP23017_TRANSPORT_H
+#define CSE_MCP23017_TRANSPORT_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+//============================================================================================//
+/**
+ * @brief The bus interface of the IO expander. All register transactions of `CSE_MCP23017` go
+ * through the three primitives below. A custom backend (another bus, a mock, a counter) can be
+ * plugged in by deriving from this class and passing it to the `CSE_MCP23017` constructor.
+ *
+ * All primitives return `MCP23017_RESP_OK` (0) on success. Write errors are returned as the
+ * `Wire.endTransmission()` codes, and short reads as `MCP23017_ERROR_RF`.
+ *
+ */
+class CSE_MCP23017_Transport {
+  public:
+    virtual ~CSE_MCP23017_Transport() {}
+
+    /**
+     * @brief Checks if a device acknowledges its address, without accessing any register.
+     *
+     * @param address The device address.
+     * @return uint8_t `MCP23017_RESP_OK` if the device is present.
+     */
+    virtual uint8_t probe (uint8_t address) = 0;
+
+    /**
+     * @brief Writes a sequence of bytes starting from a register, in a single transaction.
+     * With `length` = 0, only the register address is written, which parks the address pointer.
+     *
+     * @param address The device address.
+     * @param regAddress The absolute register address.
+     * @param data The bytes to write.
+     * @param length The number of bytes. Must not exceed `maxLength()`.
+     * @return uint8_t The response code.
+     */
+    virtual uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Sets the register address and then reads a sequence of bytes from it. Bus
+     * transports should do this without releasing the bus in between, with a repeated START.
+     *
+     * @param address The device address.
+     * @param regAddress The absolute register address.
+     * @param data The buffer for the bytes read.
+     * @param length The number of bytes to read. Must not exceed `maxLength()`.
+     * @return uint8_t The response code.
+     */
+    virtual uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Reads a sequence of bytes from the current address pointer of the device, without
+     * setting the register address first.
+     *
+     * @param address The device address.
+     * @param data The buffer for the bytes read.
+     * @param length The number of bytes to read. Must not exceed `maxLength()`.
+     * @return size_t The number of bytes received.
+     */
+    virtual size_t readN (uint8_t address, uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Returns the maximum number of data bytes in a single transaction.
+     *
+     * @return size_t The maximum length.
+     */
+    virtual size_t maxLength() = 0;
+
+    /**
+     * @brief Prepares the bus and the device after a reset. Called by `CSE_MCP23017::begin()`.
+     *
+     * @param address The device address.
+     * @return uint8_t The response code, 0 on success.
+     */
+    virtual uint8_t begin (uint8_t address) {
+      (void) address;
+      return 0;
+    }
+
+    /**
+     * @brief Returns the IOCON bits the transport needs, such as HAEN. `CSE_MCP23017` keeps
+     * these bits set in every IOCON write.
+     *
+     * @return uint8_t The IOCON bits.
+     */
+    virtual uint8_t ioconBits() {
+      return 0;
+    }
+};
+
+//============================================================================================//
+/**
+ * @brief The default transport over an Arduino `TwoWire` instance. `CSE_MCP23017` keeps one of
+ * these as a member and calls it directly, so the default path has no virtual call overhead.
+ *
+ */
+class CSE_MCP23017_TwoWire final : public CSE_MCP23017_Transport {
+  private:
+    TwoWire *wire;  // The I2C controller
+
+  public:
+    CSE_MCP23017_TwoWire (TwoWire *wirePort);
+    uint8_t probe (uint8_t address) override;
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override;
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override;
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override;
+    size_t maxLength() override;
+};
+
+//============================================================================================//
+
+#endif
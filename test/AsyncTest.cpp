@@ -0,0 +1,161 @@
+//============================================================================================//
+
+// Tests the async transaction queue against the behavioural model. The first part checks the
+// handle states from a single thread, including handles that outlive their slot. The second
+// part queues transactions from one thread while a worker thread runs `tick()`, and checks that
+// every transaction completes once, in order, with the data of the preceding write.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Async.h>
+#include <stdint.h>
+#include <thread>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   STRESS_PAIRS        20000UL
+
+//============================================================================================//
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+
+ioeAsyncHandle_t lastHandle;
+uint32_t completions;
+uint32_t callbackErrors;
+
+//============================================================================================//
+
+// The context carries the value the read must return.
+void readDone (ioeAsyncHandle_t handle, uint8_t response, const uint8_t *data, void *context) {
+  if ((response != MCP23017_RESP_OK) || (data [0] != uint8_t (uintptr_t (context)))) {
+    callbackErrors++;
+  }
+
+  if ((completions != 0) && (handle != (lastHandle + 2))) {  // A write runs in between
+    callbackErrors++;
+  }
+
+  lastHandle = handle;
+  completions++;
+}
+
+//============================================================================================//
+
+void testHandles() {
+  CSE_MCP23017_Async queue (&simulator);
+  ioeAsyncHandle_t first;
+  ioeAsyncHandle_t handle;
+  uint8_t value = 0x5A;
+  uint8_t readBack = 0;
+
+  // Handles that were never issued are not mistaken for the zeroed slots.
+  for (ioeAsyncHandle_t i = 0; i < MCP23017_ASYNC_QUEUE_SIZE; i++) {
+    HOST_CHECK_EQUAL (queue.status (i), MCP23017_ASYNC_EXPIRED);
+  }
+
+  HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 0), MCP23017_ERROR_OOR);
+  HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, MCP23017_ASYNC_DATA_SIZE + 1), MCP23017_ERROR_OOR);
+
+  HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 1, NULL, NULL, &first), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (queue.writeThenRead (SIM_ADDRESS, MCP23017_REG_OLATA, &readBack, 1, NULL, NULL, &handle), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (handle, first + 1);
+  HOST_CHECK_EQUAL (queue.status (first), MCP23017_ASYNC_PENDING);
+  HOST_CHECK_EQUAL (queue.pending(), 2);
+
+  HOST_CHECK (queue.tick());
+  HOST_CHECK_EQUAL (queue.status (first), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (queue.status (handle), MCP23017_ASYNC_PENDING);
+  HOST_CHECK (queue.tick());
+  HOST_CHECK (!queue.tick());
+  HOST_CHECK_EQUAL (queue.status (handle), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (readBack, value);
+
+  // A full queue refuses more transactions.
+  for (uint8_t i = 0; i < MCP23017_ASYNC_QUEUE_SIZE; i++) {
+    HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_RESP_OK);
+  }
+
+  HOST_CHECK_EQUAL (queue.available(), 0);
+  HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_ERROR_QF);
+  HOST_CHECK_EQUAL (queue.status (first), MCP23017_ASYNC_EXPIRED);
+
+  while (queue.tick());
+
+  // After 256 more transactions, the old handles land on the same slots and would alias with
+  // an 8-bit handle. They must still report as expired, while the new ones are tracked.
+  for (uint32_t i = 0; i < 256; i++) {
+    HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 1, NULL, NULL, &handle), MCP23017_RESP_OK);
+
+    if (i == 255) {
+      HOST_CHECK_EQUAL (queue.status (handle), MCP23017_ASYNC_PENDING);
+    }
+
+    queue.tick();
+  }
+
+  HOST_CHECK_EQUAL (handle, first + 2 + MCP23017_ASYNC_QUEUE_SIZE + 255);
+  HOST_CHECK_EQUAL (queue.status (handle), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (queue.status (first), MCP23017_ASYNC_EXPIRED);
+  HOST_CHECK_EQUAL (queue.status (first + 1), MCP23017_ASYNC_EXPIRED);
+  HOST_CHECK_EQUAL (queue.status (handle + 1), MCP23017_ASYNC_EXPIRED); // Not issued yet
+}
+
+//============================================================================================//
+
+void testConcurrent() {
+  CSE_MCP23017_Async queue (&simulator);
+  bool producerDone = false;
+
+  completions = 0;
+  callbackErrors = 0;
+
+  std::thread worker ([&queue, &producerDone]() {
+    while (true) {
+      bool done = __atomic_load_n (&producerDone, __ATOMIC_ACQUIRE);
+
+      if (!queue.tick()) {
+        if (done) {
+          break;  // Empty after the producer finished
+        }
+
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t queueFull = 0;
+  ioeAsyncHandle_t handle = 0;
+
+  for (uint32_t i = 0; i < STRESS_PAIRS; i++) {
+    uint8_t value = uint8_t (i * 7U);
+
+    // The write and the read are queued together, so the read must see the value written.
+    while (queue.available() < 2) {
+      queueFull++;
+      std::this_thread::yield();
+    }
+
+    HOST_CHECK_EQUAL (queue.write (SIM_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_RESP_OK);
+    HOST_CHECK_EQUAL (queue.writeThenRead (SIM_ADDRESS, MCP23017_REG_OLATA, NULL, 1, readDone, (void *) uintptr_t (value), &handle), MCP23017_RESP_OK);
+  }
+
+  __atomic_store_n (&producerDone, true, __ATOMIC_RELEASE);
+  worker.join();
+
+  HOST_CHECK_EQUAL (completions, STRESS_PAIRS);
+  HOST_CHECK_EQUAL (callbackErrors, 0);
+  HOST_CHECK_EQUAL (lastHandle, handle);
+  HOST_CHECK_EQUAL (queue.status (handle), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (queue.pending(), 0);
+}
+
+//============================================================================================//
+
+int main() {
+  testHandles();
+  testConcurrent();
+
+  return hostTestResult ("AsyncTest");
+}
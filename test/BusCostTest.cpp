@@ -0,0 +1,13 @@
+//============================================================================================//
+
+// Runs the baseline table of the BusCost example on the host. The sketch is compiled as it is,
+// so the host test and the example can not drift apart. Fails when any call exceeds its
+// baseline.
+
+#include "../examples/BusCost/BusCost.ino"
+
+//============================================================================================//
+
+int main() {
+  return runBusCost() ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+//============================================================================================//
+
+// Checks the vertical counter of the debouncer: a change is accepted after exactly the set
+// number of differing samples, a bounce restarts the count, pins are counted independently,
+// and reset() clears the counts in progress.
+
+#include <CSE_MCP23017_Debouncer.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+// Feeds the same sample a number of times and returns the OR of the changes reported.
+uint16_t feed (CSE_MCP23017_Debouncer &debouncer, uint16_t sample, uint8_t times) {
+  uint16_t changed = 0;
+
+  for (uint8_t i = 0; i < times; i++) {
+    changed |= debouncer.update (sample);
+  }
+
+  return changed;
+}
+
+//============================================================================================//
+
+void testAcceptance() {
+  for (uint8_t samples = 1; samples <= MCP23017_DEBOUNCE_MAX_SAMPLES; samples++) {
+    CSE_MCP23017_Debouncer debouncer (samples, 0x0000U);
+
+    // One sample short of the count, nothing changes.
+    HOST_CHECK_EQUAL (feed (debouncer, 0x0001U, samples - 1), 0);
+    HOST_CHECK_EQUAL (debouncer.state(), 0x0000U);
+
+    HOST_CHECK_EQUAL (debouncer.update (0x0001U), 0x0001U);
+    HOST_CHECK_EQUAL (debouncer.state(), 0x0001U);
+    HOST_CHECK_EQUAL (debouncer.rose(), 0x0001U);
+    HOST_CHECK_EQUAL (debouncer.fell(), 0);
+
+    // The edges are only reported by the update that accepted them.
+    HOST_CHECK_EQUAL (debouncer.update (0x0001U), 0);
+    HOST_CHECK_EQUAL (debouncer.rose(), 0);
+
+    HOST_CHECK_EQUAL (feed (debouncer, 0x0000U, samples - 1), 0);
+    HOST_CHECK_EQUAL (debouncer.update (0x0000U), 0x0001U);
+    HOST_CHECK_EQUAL (debouncer.fell(), 0x0001U);
+    HOST_CHECK_EQUAL (debouncer.state(), 0x0000U);
+  }
+}
+
+void testBounce() {
+  CSE_MCP23017_Debouncer debouncer (4, 0x0000U);
+
+  // A matching sample restarts the count.
+  HOST_CHECK_EQUAL (feed (debouncer, 0x8000U, 3), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x0000U), 0);
+  HOST_CHECK_EQUAL (feed (debouncer, 0x8000U, 3), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x8000U), 0x8000U);
+  HOST_CHECK_EQUAL (debouncer.state(), 0x8000U);
+}
+
+void testParallel() {
+  CSE_MCP23017_Debouncer debouncer (4, 0x00FFU);
+
+  // Pin 8 starts rising, then pin 0 starts falling two samples later. Pin 4 bounces.
+  HOST_CHECK_EQUAL (debouncer.update (0x01FFU), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x01EFU), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x01FEU), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x01FEU), 0x0100U);
+  HOST_CHECK_EQUAL (debouncer.rose(), 0x0100U);
+  HOST_CHECK_EQUAL (debouncer.update (0x01FEU), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x01FEU), 0x0001U);
+  HOST_CHECK_EQUAL (debouncer.fell(), 0x0001U);
+  HOST_CHECK_EQUAL (debouncer.state(), 0x01FEU);
+
+  // Every pin at once.
+  HOST_CHECK_EQUAL (feed (debouncer, 0xFE01U, 4), 0xFFFFU);
+  HOST_CHECK_EQUAL (debouncer.state(), 0xFE01U);
+}
+
+void testReset() {
+  CSE_MCP23017_Debouncer debouncer (4, 0x0000U);
+
+  // reset() sets the state without filtering and drops the counts in progress.
+  HOST_CHECK_EQUAL (feed (debouncer, 0x0003U, 3), 0);
+  debouncer.reset (0x0002U);
+  HOST_CHECK_EQUAL (debouncer.state(), 0x0002U);
+  HOST_CHECK_EQUAL (debouncer.rose(), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x0003U), 0);
+  HOST_CHECK_EQUAL (feed (debouncer, 0x0003U, 2), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x0003U), 0x0001U);
+
+  // The sample count is clamped to the counter width.
+  debouncer.setSamples (0);
+  HOST_CHECK_EQUAL (debouncer.update (0x0000U), 0x0003U);
+  debouncer.setSamples (MCP23017_DEBOUNCE_MAX_SAMPLES + 5);
+  HOST_CHECK_EQUAL (feed (debouncer, 0x0001U, MCP23017_DEBOUNCE_MAX_SAMPLES - 1), 0);
+  HOST_CHECK_EQUAL (debouncer.update (0x0001U), 0x0001U);
+}
+
+//============================================================================================//
+
+int main() {
+  testAcceptance();
+  testBounce();
+  testParallel();
+  testReset();
+
+  return hostTestResult ("DebouncerTest");
+}
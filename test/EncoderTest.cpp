@@ -0,0 +1,140 @@
+//============================================================================================//
+
+// Runs the quadrature decoder against the simulator: full cycles in both directions and an
+// invalid jump, decoded by polling and from the interrupt service burst. With interrupts, two
+// steps before the service must both count, from INTCAP and from GPIO.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Encoder.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   HOST_INT_PIN        2
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &simulator);
+
+// Clockwise, A leads B: AB = 11, 01, 00, 10 and back to 11.
+const uint8_t cycle [4][2] = {{HIGH, HIGH}, {LOW, HIGH}, {LOW, LOW}, {HIGH, LOW}};
+
+//============================================================================================//
+
+uint8_t intaLevel() {
+  return simulator.interruptOutput (MCP23017_PORT_A);
+}
+
+void intaEdge() {
+  void (*handler)(void) = hostInterruptHandler (HOST_INT_PIN);
+
+  if (handler != NULL) {
+    handler();
+  }
+}
+
+void drive (uint8_t pinA, uint8_t pinB, uint8_t phase) {
+  simulator.setInput (pinA, cycle [phase & 0x3U][0]);
+  simulator.setInput (pinB, cycle [phase & 0x3U][1]);
+}
+
+//============================================================================================//
+
+void testPolled() {
+  CSE_MCP23017_Encoder encoder (&ioExpander);
+  HOST_CHECK_EQUAL (encoder.attach (0, 1), 0);
+  HOST_CHECK_EQUAL (encoder.attach (9, 10), 1);
+  HOST_CHECK_EQUAL (encoder.attach (1, 2), -1);  // Pin 1 is taken
+  HOST_CHECK_EQUAL (encoder.begin(), MCP23017_RESP_OK);
+
+  // A full cycle clockwise counts four quarter steps up. Encoder 1 does not move.
+  for (uint8_t phase = 1; phase <= 4; phase++) {
+    drive (0, 1, phase);
+    HOST_CHECK_EQUAL (encoder.poll(), MCP23017_RESP_OK);
+    HOST_CHECK_EQUAL (encoder.read (0), phase);
+  }
+
+  HOST_CHECK_EQUAL (encoder.read (1), 0);
+
+  // Two full cycles counter-clockwise on both encoders.
+  for (uint8_t phase = 8; phase > 0; phase--) {
+    drive (0, 1, phase - 1);
+    drive (9, 10, phase - 1);
+    HOST_CHECK_EQUAL (encoder.poll(), MCP23017_RESP_OK);
+  }
+
+  HOST_CHECK_EQUAL (encoder.read (0), -4);
+  HOST_CHECK_EQUAL (encoder.read (1), -8);
+  HOST_CHECK_EQUAL (encoder.errors (0), 0);
+  HOST_CHECK_EQUAL (encoder.errors (1), 0);
+
+  // Both pins changing between two reads is an invalid jump. It is not counted.
+  drive (0, 1, 2);
+  HOST_CHECK_EQUAL (encoder.poll(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (encoder.read (0), -4);
+  HOST_CHECK_EQUAL (encoder.errors (0), 1);
+
+  // Decoding goes on from the new state.
+  drive (0, 1, 3);
+  HOST_CHECK_EQUAL (encoder.poll(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (encoder.read (0), -3);
+
+  encoder.write (0, 100);
+  HOST_CHECK_EQUAL (encoder.read (0), 100);
+  HOST_CHECK_EQUAL (encoder.read (7), 0);
+}
+
+void testInterruptDriven() {
+  simulator.attachOutput (MCP23017_PORT_A, intaEdge);
+  hostSetPinSource (HOST_INT_PIN, intaLevel);
+  simulator.setInputs (0xFFFFU);
+  HOST_CHECK_EQUAL (ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR), MCP23017_RESP_OK);
+
+  CSE_MCP23017_Encoder encoder (&ioExpander);
+  HOST_CHECK_EQUAL (encoder.attach (4, 5), 0);
+  HOST_CHECK_EQUAL (encoder.attach (12, 13), 1);
+  HOST_CHECK_EQUAL (encoder.begin (true), MCP23017_RESP_OK);
+
+  // One step per service, clockwise on encoder 0 and counter-clockwise on encoder 1.
+  for (uint8_t phase = 1; phase <= 4; phase++) {
+    drive (4, 5, phase);
+    ioExpander.dispatchInterrupt();
+    drive (12, 13, 4 - phase);
+    ioExpander.dispatchInterrupt();
+  }
+
+  HOST_CHECK_EQUAL (encoder.read (0), 4);
+  HOST_CHECK_EQUAL (encoder.read (1), -4);
+
+  // Two steps before the service. The first is in INTCAP, the second in GPIO.
+  drive (4, 5, 1);
+  drive (4, 5, 2);
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (encoder.read (0), 6);
+  HOST_CHECK_EQUAL (encoder.errors (0), 0);
+
+  // Three steps before the service skip the middle state, which is an invalid jump.
+  drive (4, 5, 3);
+  drive (4, 5, 4);
+  drive (4, 5, 5);
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (encoder.read (0), 7);
+  HOST_CHECK_EQUAL (encoder.errors (0), 1);
+
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+  HOST_CHECK_EQUAL (encoder.errors (1), 0);
+}
+
+//============================================================================================//
+
+int main() {
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+
+  testPolled();
+  testInterruptDriven();
+  hostSetPinSource (HOST_INT_PIN, NULL);
+
+  return hostTestResult ("EncoderTest");
+}
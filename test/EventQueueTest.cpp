@@ -0,0 +1,178 @@
+//============================================================================================//
+
+// Stress test of the interrupt event queue with a producer and a consumer thread. Checks that
+// events arrive in order and intact, that nothing is lost while the producer stays below the
+// capacity, and that every event pushed into a full queue is counted by `dropped()`.
+
+#include <CSE_MCP23017_EventQueue.h>
+#include <thread>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   STRESS_EVENTS       200000UL
+
+//============================================================================================//
+
+// Every field is derived from the sequence number, so a torn slot is detected.
+ioeEvent_t makeEvent (uint32_t sequence) {
+  ioeEvent_t event;
+  event.timestamp = sequence;
+  event.device = uint8_t (sequence);
+  event.pin = int8_t (sequence & 0x0FU);
+  event.flags = uint16_t (sequence);
+  event.capture = uint16_t (~sequence);
+  event.gpio = uint16_t (sequence >> 16);
+  event.serviced = (sequence & 0x1U) != 0;
+  return event;
+}
+
+bool eventIntact (const ioeEvent_t &event) {
+  ioeEvent_t expected = makeEvent (event.timestamp);
+
+  return (event.device == expected.device) && (event.pin == expected.pin) && (event.flags == expected.flags) &&
+    (event.capture == expected.capture) && (event.gpio == expected.gpio) && (event.serviced == expected.serviced);
+}
+
+//============================================================================================//
+
+void testSingleThread() {
+  CSE_MCP23017_EventQueue queue;
+  ioeEvent_t event;
+
+  HOST_CHECK (!queue.pop (event));
+
+  for (uint32_t i = 0; i < MCP23017_EVENT_QUEUE_SIZE; i++) {
+    HOST_CHECK (queue.push (makeEvent (i)));
+  }
+
+  HOST_CHECK_EQUAL (queue.count(), MCP23017_EVENT_QUEUE_SIZE);
+  HOST_CHECK (!queue.push (makeEvent (MCP23017_EVENT_QUEUE_SIZE)));
+  HOST_CHECK_EQUAL (queue.dropped(), 1);
+
+  // Entries can be modified in place before they are removed.
+  queue.peek()->serviced = true;
+
+  for (uint32_t i = 0; i < MCP23017_EVENT_QUEUE_SIZE; i++) {
+    HOST_CHECK (queue.pop (event));
+    HOST_CHECK_EQUAL (event.timestamp, i);
+
+    if (i == 0) {
+      HOST_CHECK (event.serviced);
+    }
+  }
+
+  HOST_CHECK_EQUAL (queue.count(), 0);
+  HOST_CHECK (!queue.pop (event));
+}
+
+//============================================================================================//
+
+// The producer only pushes when the queue has room, so no event may be lost or reordered.
+void testNoLoss() {
+  CSE_MCP23017_EventQueue queue;
+  uint32_t failedPushes = 0;
+
+  std::thread producer ([&queue, &failedPushes]() {
+    for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+      while (queue.count() >= MCP23017_EVENT_QUEUE_SIZE) {
+        std::this_thread::yield();
+      }
+
+      if (!queue.push (makeEvent (i))) {
+        failedPushes++;
+      }
+    }
+  });
+
+  uint32_t expected = 0;
+  uint32_t errors = 0;
+  ioeEvent_t event;
+
+  while (expected < STRESS_EVENTS) {
+    if (!queue.pop (event)) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    if ((event.timestamp != expected) || !eventIntact (event)) {
+      errors++;
+    }
+
+    expected = event.timestamp + 1;
+  }
+
+  producer.join();
+
+  HOST_CHECK_EQUAL (failedPushes, 0);
+  HOST_CHECK_EQUAL (errors, 0);
+  HOST_CHECK_EQUAL (queue.dropped(), 0);
+  HOST_CHECK_EQUAL (queue.count(), 0);
+}
+
+//============================================================================================//
+
+// The producer pushes without waiting, so the queue overflows. The events that arrive must
+// still be in order and intact, and every lost event must be counted.
+void testOverflow() {
+  CSE_MCP23017_EventQueue queue;
+  uint32_t failedPushes = 0;
+  bool producerDone = false;
+
+  std::thread producer ([&queue, &failedPushes, &producerDone]() {
+    for (uint32_t i = 0; i < STRESS_EVENTS; i++) {
+      if (!queue.push (makeEvent (i))) {
+        failedPushes++;
+      }
+
+      if ((i & 0x3FU) == 0) {
+        std::this_thread::yield();
+      }
+    }
+
+    __atomic_store_n (&producerDone, true, __ATOMIC_RELEASE);
+  });
+
+  uint32_t received = 0;
+  uint32_t errors = 0;
+  bool first = true;
+  uint32_t last = 0;
+  ioeEvent_t event;
+
+  while (true) {
+    bool done = __atomic_load_n (&producerDone, __ATOMIC_ACQUIRE);
+
+    if (queue.pop (event)) {
+      if ((!first && (event.timestamp <= last)) || !eventIntact (event)) {
+        errors++;
+      }
+
+      first = false;
+      last = event.timestamp;
+      received++;
+    }
+    else if (done) {
+      break;  // Empty after the producer finished
+    }
+    else {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+
+  HOST_CHECK_EQUAL (errors, 0);
+  HOST_CHECK (failedPushes > 0);
+  HOST_CHECK_EQUAL (received + failedPushes, STRESS_EVENTS);
+  HOST_CHECK_EQUAL (queue.dropped(), uint16_t (failedPushes));
+}
+
+//============================================================================================//
+
+int main() {
+  testSingleThread();
+  testNoLoss();
+  testOverflow();
+
+  return hostTestResult ("EventQueueTest");
+}
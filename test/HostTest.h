@@ -0,0 +1,37 @@
+//============================================================================================//
+
+// Checks for the host tests. A failed check prints its location and the test keeps running,
+// so one run reports every failure. `hostTestResult()` gives the exit code for CTest.
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+//============================================================================================//
+
+static int hostFailures = 0;
+
+#define   HOST_CHECK(condition)       hostCheck ((condition), #condition, __FILE__, __LINE__)
+#define   HOST_CHECK_EQUAL(a, b)      hostCheckEqual ((long long) (a), (long long) (b), #a, #b, __FILE__, __LINE__)
+
+static inline void hostCheck (bool passed, const char *text, const char *file, int line) {
+  if (!passed) {
+    fprintf (stderr, "%s:%d: check failed: %s\n", file, line, text);
+    hostFailures++;
+  }
+}
+
+static inline void hostCheckEqual (long long a, long long b, const char *textA, const char *textB, const char *file, int line) {
+  if (a != b) {
+    fprintf (stderr, "%s:%d: check failed: %s == %s (%lld != %lld)\n", file, line, textA, textB, a, b);
+    hostFailures++;
+  }
+}
+
+static inline int hostTestResult (const char *name) {
+  printf ("%s: %s (%d failed)\n", name, (hostFailures == 0) ? "PASS" : "FAIL", hostFailures);
+  return (hostFailures == 0) ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,187 @@
+//============================================================================================//
+
+// Runs the keypad scanner against the simulator with a model of a matrix without diodes. A
+// pressed key joins its row and column, so a column reads low if any driven row reaches it
+// through the pressed keys. Checks single keys, two keys in a column, and that the ghost
+// patterns (two rows sharing two or more columns) are reported and do not change the state.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Keypad.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+
+//============================================================================================//
+
+// Passes everything to the simulator, and updates the column levels after every write, since
+// only the writes to IODIRA and OLATA change which rows are driven.
+class KeypadBoard final : public CSE_MCP23017_Transport {
+  private:
+    CSE_MCP23017_Sim *sim;
+    uint64_t keys = 0;
+
+  public:
+    KeypadBoard (CSE_MCP23017_Sim *simulator) {
+      sim = simulator;
+    }
+
+    void press (uint8_t row, uint8_t column, bool down) {
+      uint64_t bit = uint64_t (1U) << ((row * MCP23017_KEYPAD_COLUMNS) + column);
+      keys = down ? (keys | bit) : (keys & ~bit);
+      wire();
+    }
+
+    void wire() {
+      uint8_t lowRows = uint8_t (~sim->peek (MCP23017_REG_IODIRA)) & uint8_t (~sim->peek (MCP23017_REG_OLATA));
+      uint8_t lowColumns = 0;
+      bool spread = true;
+
+      // Spread the low level through the pressed keys until nothing changes.
+      while (spread) {
+        spread = false;
+
+        for (uint8_t key = 0; key < MCP23017_KEYPAD_KEYS; key++) {
+          if (((keys >> key) & 0x1U) == 0) {
+            continue;
+          }
+
+          uint8_t row = uint8_t (1U << (key / MCP23017_KEYPAD_COLUMNS));
+          uint8_t column = uint8_t (1U << (key % MCP23017_KEYPAD_COLUMNS));
+
+          if ((lowRows & row) && !(lowColumns & column)) {
+            lowColumns |= column;
+            spread = true;
+          }
+
+          if ((lowColumns & column) && !(lowRows & row)) {
+            lowRows |= row;
+            spread = true;
+          }
+        }
+      }
+
+      for (uint8_t column = 0; column < MCP23017_KEYPAD_COLUMNS; column++) {
+        if ((lowColumns >> column) & 0x1U) {
+          sim->setInput (uint8_t (MCP23017_KEYPAD_ROWS + column), LOW);
+        }
+        else {
+          sim->releaseInput (uint8_t (MCP23017_KEYPAD_ROWS + column)); // Pulled up
+        }
+      }
+    }
+
+    uint8_t begin (uint8_t address) override {
+      return sim->begin (address);
+    }
+
+    uint8_t probe (uint8_t address) override {
+      return sim->probe (address);
+    }
+
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override {
+      uint8_t response = sim->write (address, regAddress, data, length);
+      wire();
+      return response;
+    }
+
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override {
+      return sim->writeThenRead (address, regAddress, data, length);
+    }
+
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override {
+      return sim->readN (address, data, length);
+    }
+
+    size_t maxLength() override {
+      return sim->maxLength();
+    }
+};
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+KeypadBoard board (&simulator);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &board);
+CSE_MCP23017_Keypad keypad (&ioExpander);
+
+uint64_t keyBit (uint8_t row, uint8_t column) {
+  return uint64_t (1U) << ((row * MCP23017_KEYPAD_COLUMNS) + column);
+}
+
+//============================================================================================//
+
+void testKeys() {
+  HOST_CHECK_EQUAL (keypad.update(), false);
+  HOST_CHECK_EQUAL (keypad.state(), 0);
+
+  board.press (2, 5, true);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK (keypad.pressedKeys() == keyBit (2, 5));
+  HOST_CHECK (keypad.isPressed ((2 * MCP23017_KEYPAD_COLUMNS) + 5));
+
+  // Two keys in a column are not ambiguous, the other rows float.
+  board.press (6, 5, true);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK (keypad.pressedKeys() == keyBit (6, 5));
+  HOST_CHECK (keypad.state() == (keyBit (2, 5) | keyBit (6, 5)));
+  HOST_CHECK_EQUAL (keypad.ghosted(), false);
+
+  board.press (2, 5, false);
+  board.press (6, 5, false);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK (keypad.releasedKeys() == (keyBit (2, 5) | keyBit (6, 5)));
+  HOST_CHECK_EQUAL (keypad.state(), 0);
+
+  // Idle, all the columns read high, so no scan.
+  HOST_CHECK_EQUAL (keypad.update(), false);
+}
+
+void testGhost() {
+  board.press (0, 0, true);
+  board.press (0, 3, true);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK_EQUAL (keypad.ghosted(), false);
+  uint64_t held = keyBit (0, 0) | keyBit (0, 3);
+  HOST_CHECK (keypad.state() == held);
+
+  // Three corners of a rectangle. Row 1 reaches column 3 through the keys of row 0, so key
+  // (1, 3) reads pressed too. Rows 0 and 1 share two columns, and the scan is ignored.
+  board.press (1, 0, true);
+  HOST_CHECK_EQUAL (keypad.update(), false);
+  HOST_CHECK_EQUAL (keypad.ghosted(), true);
+  HOST_CHECK (keypad.state() == held);
+  HOST_CHECK_EQUAL (keypad.pressedKeys(), 0);
+
+  // All four corners pressed are just as ambiguous.
+  board.press (1, 3, true);
+  HOST_CHECK_EQUAL (keypad.update(), false);
+  HOST_CHECK_EQUAL (keypad.ghosted(), true);
+  HOST_CHECK (keypad.state() == held);
+
+  // Rows that share only one column are fine.
+  board.press (1, 3, false);
+  board.press (0, 3, false);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK_EQUAL (keypad.ghosted(), false);
+  HOST_CHECK (keypad.state() == (keyBit (0, 0) | keyBit (1, 0)));
+  HOST_CHECK (keypad.pressedKeys() == keyBit (1, 0));
+  HOST_CHECK (keypad.releasedKeys() == keyBit (0, 3));
+
+  board.press (0, 0, false);
+  board.press (1, 0, false);
+  HOST_CHECK_EQUAL (keypad.update(), true);
+  HOST_CHECK_EQUAL (keypad.state(), 0);
+}
+
+//============================================================================================//
+
+int main() {
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (keypad.begin(), MCP23017_RESP_OK);
+
+  testKeys();
+  testGhost();
+
+  return hostTestResult ("KeypadTest");
+}
@@ -0,0 +1,206 @@
+//============================================================================================//
+
+// Runs the LED matrix refresh against the simulator. Every byte written to the output latches
+// is replayed in order, so the test sees each state the pins go through, also the ones inside
+// a single transaction. Checks that a lit row only ever shows its own data, and that a buffer
+// swap requested in the middle of a frame waits for the next refresh.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_LedMatrix.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   TICKS_PER_ROW       MCP23017_LED_LEVELS
+#define   TICKS_PER_FRAME     (MCP23017_LED_ROWS * MCP23017_LED_LEVELS)
+
+//============================================================================================//
+
+// Passes everything to the simulator, and follows the latches byte by byte. The matrix is
+// driven in the BANK = 0 sequential mode, so the register address increments with each byte.
+class LatchProbe final : public CSE_MCP23017_Transport {
+  private:
+    CSE_MCP23017_Sim *sim;
+
+  public:
+    uint8_t rows = 0xFFU; // OLATA
+    uint8_t columns = 0x00U;  // OLATB
+    uint64_t frame = 0; // The frame that may be shown
+    uint64_t altFrame = 0;  // Also accepted, while a swap is due
+    uint8_t shownRows = 0;  // Rows seen lit
+    uint32_t wrongStates = 0; // States where a row showed data that is not its own
+
+    LatchProbe (CSE_MCP23017_Sim *simulator) {
+      sim = simulator;
+    }
+
+    void check() {
+      uint8_t selected = uint8_t (~rows);  // Rows are active low
+
+      if ((selected == 0) || (columns == 0)) {
+        return; // Dark
+      }
+
+      // One row at a time, and only with its own data.
+      if ((selected & (selected - 1)) != 0) {
+        wrongStates++;
+        return;
+      }
+
+      uint8_t row = uint8_t (__builtin_ctz (selected));
+      uint8_t data = uint8_t (frame >> (row * MCP23017_LED_COLUMNS));
+      uint8_t altData = uint8_t (altFrame >> (row * MCP23017_LED_COLUMNS));
+
+      if ((columns != data) && (columns != altData)) {
+        wrongStates++;
+      }
+
+      shownRows |= selected;
+    }
+
+    uint8_t begin (uint8_t address) override {
+      return sim->begin (address);
+    }
+
+    uint8_t probe (uint8_t address) override {
+      return sim->probe (address);
+    }
+
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override {
+      uint8_t response = sim->write (address, regAddress, data, length);
+
+      for (size_t i = 0; (i < length) && (response == MCP23017_RESP_OK); i++) {
+        uint8_t reg = uint8_t (regAddress + i);
+
+        if (reg == MCP23017_REG_OLATA) {
+          rows = data [i];
+        }
+        else if (reg == MCP23017_REG_OLATB) {
+          columns = data [i];
+        }
+        else {
+          continue;
+        }
+
+        check();
+      }
+
+      return response;
+    }
+
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override {
+      return sim->writeThenRead (address, regAddress, data, length);
+    }
+
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override {
+      return sim->readN (address, data, length);
+    }
+
+    size_t maxLength() override {
+      return sim->maxLength();
+    }
+};
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+LatchProbe probe (&simulator);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &probe);
+CSE_MCP23017_LedMatrix matrix (&ioExpander);
+
+// Every row has its own pattern, so a row showing another row's data is detected.
+const uint64_t frameA = 0x8040201008040201ULL;
+const uint64_t frameB = 0x0102040810204080ULL;
+
+//============================================================================================//
+
+void run (uint16_t ticks) {
+  for (uint16_t i = 0; i < ticks; i++) {
+    HOST_CHECK_EQUAL (matrix.tick(), MCP23017_RESP_OK);
+  }
+}
+
+// Checks the pins against the row being shown, in the middle of its slot.
+void checkRow (uint8_t row, uint64_t frame) {
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), uint8_t (~(1U << row)));
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), uint8_t (frame >> (row * MCP23017_LED_COLUMNS)));
+}
+
+//============================================================================================//
+
+void testRefresh() {
+  HOST_CHECK_EQUAL (matrix.begin(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IODIRA), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IODIRB), 0);
+
+  matrix.setFrame (frameA);
+  matrix.show();
+  probe.frame = frameA;
+  probe.altFrame = frameA;
+
+  // The swap happens at the first row, and every row is shown at full brightness.
+  run (1);
+  HOST_CHECK (matrix.ready());
+  HOST_CHECK (matrix.getFrame() == frameA);
+  checkRow (0, frameA);
+  run (TICKS_PER_FRAME - 1);
+  HOST_CHECK_EQUAL (probe.shownRows, 0xFFU);
+  HOST_CHECK_EQUAL (probe.wrongStates, 0);
+
+  // At half brightness, the rows are blanked in the middle of the slot.
+  matrix.setBrightness (TICKS_PER_ROW / 2);
+  run (TICKS_PER_ROW / 2);
+  checkRow (0, frameA);
+  run (1);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0xFFU);
+  run (TICKS_PER_FRAME - (TICKS_PER_ROW / 2) - 1);
+  HOST_CHECK_EQUAL (probe.wrongStates, 0);
+  matrix.setBrightness (MCP23017_LED_LEVELS);
+}
+
+void testSwapMidFrame() {
+  // Stop in the middle of row 3, then draw and show a new frame.
+  run ((3 * TICKS_PER_ROW) + 2);
+  matrix.setFrame (frameB);
+  matrix.show();
+  HOST_CHECK (!matrix.ready());
+
+  // The old frame keeps being shown up to the last row.
+  run (TICKS_PER_ROW);
+  checkRow (4, frameA);
+  run (3 * TICKS_PER_ROW);
+  checkRow (7, frameA);
+  HOST_CHECK (!matrix.ready());
+  HOST_CHECK (matrix.getFrame() == frameA);
+
+  // The new frame starts with the next refresh.
+  probe.altFrame = frameB;
+  run (TICKS_PER_ROW);
+  HOST_CHECK (matrix.ready());
+  HOST_CHECK (matrix.getFrame() == frameB);
+  checkRow (0, frameB);
+
+  probe.frame = frameB;
+  probe.altFrame = frameB;
+  run (TICKS_PER_FRAME);
+  checkRow (0, frameB);
+  HOST_CHECK_EQUAL (probe.wrongStates, 0);
+
+  // The back buffer holds the old frame after the swap.
+  matrix.setFrame (matrix.getFrame());
+  matrix.setPixel (0, 0, false);
+  matrix.show();
+  run (TICKS_PER_FRAME);
+  HOST_CHECK (matrix.getFrame() == (frameB & ~uint64_t (1)));
+}
+
+//============================================================================================//
+
+int main() {
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+
+  testRefresh();
+  testSwapMidFrame();
+
+  return hostTestResult ("LedMatrixTest");
+}
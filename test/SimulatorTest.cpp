@@ -0,0 +1,486 @@
+//============================================================================================//
+
+// Runs the register and interrupt paths of the library against the behavioural model:
+// readAll() in every access mode, the register setup of attachInterrupt(), and the service of
+// host interrupts by isrSupervisor() through dispatchInterrupt().
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include <CSE_MCP23017_Counter.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   HOST_INT_PIN        2
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017_Counter counter (&simulator);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &counter);
+
+int isrCount [MCP23017_PINCOUNT];
+
+//============================================================================================//
+
+void isr (int8_t pin) {
+  if ((pin >= 0) && (pin < int8_t (MCP23017_PINCOUNT))) {
+    isrCount [pin]++;
+  }
+}
+
+uint8_t intaLevel() {
+  return simulator.interruptOutput (MCP23017_PORT_A);
+}
+
+// The model raises INTA, which the host sees as an edge on its interrupt pin.
+void intaEdge() {
+  void (*handler)(void) = hostInterruptHandler (HOST_INT_PIN);
+
+  if (handler != NULL) {
+    handler();
+  }
+}
+
+void service() {
+  ioExpander.dispatchInterrupt();
+  hostAdvanceMicros (20000UL); // Past the holdoff
+  ioExpander.dispatchInterrupt(); // Re-arm
+}
+
+//============================================================================================//
+
+void testReadAll() {
+  // Distinct values in the writable registers, except IOCON and the latches of the outputs.
+  for (uint8_t i = 0; i < MCP23017_SIM_REGCOUNT; i++) {
+    if ((i != MCP23017_REG_IOCON) && (i != MCP23017_REG_IOCON_) && ((i < MCP23017_REG_INTFA) || (i > MCP23017_REG_GPIOB))) {
+      simulator.poke (i, uint8_t (0x40U + i));
+    }
+  }
+
+  const uint8_t modes [3][2] = {
+    {MCP23017_BANK_PAIR, MCP23017_ADDR_SEQUENTIAL},
+    {MCP23017_BANK_GROUP, MCP23017_ADDR_SEQUENTIAL},
+    {MCP23017_BANK_GROUP, MCP23017_ADDR_BYTE}
+  };
+
+  for (uint8_t m = 0; m < 3; m++) {
+    HOST_CHECK_EQUAL (ioExpander.setAccessMode (modes [m][0], modes [m][1]), MCP23017_RESP_OK);
+    HOST_CHECK_EQUAL (ioExpander.readAll(), MCP23017_RESP_OK);
+
+    for (uint8_t i = 0; i < MCP23017_SIM_REGCOUNT; i++) {
+      HOST_CHECK_EQUAL (ioExpander.regBank [i], simulator.peek (i));
+    }
+  }
+
+  // The mode can not change in the middle of a batch.
+  ioExpander.beginBatch();
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.setAccessMode (MCP23017_BANK_PAIR, MCP23017_ADDR_SEQUENTIAL), MCP23017_ERROR_OF);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 0);
+  ioExpander.commit();
+
+  HOST_CHECK_EQUAL (ioExpander.setAccessMode (MCP23017_BANK_PAIR, MCP23017_ADDR_SEQUENTIAL), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IOCON) & ((1U << MCP23017_BIT_BANK) | (1U << MCP23017_BIT_SEQOP)), 0);
+
+  // Back to the power-on state for the interrupt tests.
+  ioExpander.begin();
+  simulator.reset();
+}
+
+//============================================================================================//
+
+void testBeginAccessMode() {
+  // Without a reset pin, the IOE can be left in BANK = 1 and SEQOP = 1 by an earlier run.
+  // begin() must restore the default access mode without changing the output latches.
+  simulator.poke (MCP23017_REG_OLATA, 0x5AU);
+  simulator.poke (MCP23017_REG_IOCON, ((1U << MCP23017_BIT_BANK) | (1U << MCP23017_BIT_SEQOP)));
+
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IOCON) & ((1U << MCP23017_BIT_BANK) | (1U << MCP23017_BIT_SEQOP)), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0x5AU);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENB), 0);
+
+  HOST_CHECK_EQUAL (ioExpander.readAll(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.regBank [MCP23017_REG_OLATA], 0x5AU);
+
+  simulator.reset();
+  ioExpander.begin();
+}
+
+//============================================================================================//
+
+void testBatch() {
+  // Values the library has not written, which a bridged gap must keep.
+  simulator.poke (MCP23017_REG_IPOLA, 0x5AU);
+  simulator.poke (MCP23017_REG_DEFVALB, 0xA5U);
+
+  HOST_CHECK_EQUAL (ioExpander.beginBatch(), MCP23017_RESP_OK);
+  counter.reset();
+
+  // Sparse dirty registers on both ports: IODIRA, IODIRB, IPOLB, GPPUA and OLATB.
+  ioExpander.pinMode (3, OUTPUT);
+  ioExpander.pinMode (12, OUTPUT);
+  ioExpander.setPinInputPolarity (9, HIGH);
+  ioExpander.pinMode (5, INPUT_PULLUP);
+  ioExpander.digitalWrite (12, HIGH);
+  HOST_CHECK (ioExpander.batchPending());
+  HOST_CHECK_EQUAL (counter.counts().transactions, 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IODIRA), 0xFFU);
+
+  // IODIRA to IPOLB in one burst, bridging IPOLA. IOCON and GPIO are never bridged, so GPPUA
+  // and OLATB take one burst each.
+  HOST_CHECK_EQUAL (ioExpander.commit(), MCP23017_RESP_OK);
+  HOST_CHECK (!ioExpander.batchPending());
+  HOST_CHECK_EQUAL (counter.counts().transactions, 3);
+
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IODIRA), 0xF7U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IODIRB), 0xEFU);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IPOLA), 0x5AU);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_IPOLB), 0x02U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_DEFVALB), 0xA5U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPPUA), 0x20U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPPUB), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x10U);
+
+  // Nothing is left to write.
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.commit(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 0);
+
+  simulator.reset();
+  ioExpander.begin();
+}
+
+//============================================================================================//
+
+void testPolling() {
+  ioExpander.pinMode (0, INPUT_PULLUP);
+  ioExpander.pinMode (1, INPUT_PULLUP);
+  ioExpander.pinMode (10, INPUT_PULLUP);
+  ioExpander.pinMode (15, OUTPUT);
+  simulator.setInputs (0xFFFFU);
+
+  HOST_CHECK_EQUAL (ioExpander.setPolling (true, 1, 8), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (1, isr, MCP23017_INT_CHANGE), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (10, isr, MCP23017_INT_FALLING), MCP23017_RESP_OK);
+
+  // No poll before the interval has elapsed, and one GPIO read per poll after that.
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 0);
+  hostAdvanceMicros (1000UL);
+  HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 1);
+  HOST_CHECK_EQUAL (ioExpander.getPollInterval(), 2);
+
+  // Only the input changes are reported, and only the matching ISRs are called.
+  simulator.setInput (0, LOW);
+  simulator.setInput (1, LOW);
+  simulator.setInput (10, LOW);
+  ioExpander.digitalWrite (15, HIGH);
+  hostAdvanceMicros (2000UL);
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0x0403U);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 1);
+  HOST_CHECK_EQUAL (isrCount [1], 1);
+  HOST_CHECK_EQUAL (isrCount [10], 1);
+  HOST_CHECK_EQUAL (ioExpander.getPollInterval(), 1);
+
+  simulator.setInput (1, HIGH);
+  simulator.setInput (10, HIGH);
+  hostAdvanceMicros (1000UL);
+  HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0x0402U);
+  HOST_CHECK_EQUAL (isrCount [1], 2);
+  HOST_CHECK_EQUAL (isrCount [10], 1);
+
+  // The interrupt registers are not used, and the latches are as written.
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENA), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENB), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_INTCONB), 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x80U);
+
+  // Idle polls back off to the ceiling.
+  for (uint8_t i = 0; i < 5; i++) {
+    hostAdvanceMicros (8000UL);
+    HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0);
+  }
+
+  HOST_CHECK_EQUAL (ioExpander.getPollInterval(), 8);
+
+  HOST_CHECK_EQUAL (ioExpander.setPolling (false), MCP23017_RESP_OK);
+  simulator.setInput (1, LOW);
+  hostAdvanceMicros (8000UL);
+  HOST_CHECK_EQUAL (ioExpander.pollChanges(), 0);
+  HOST_CHECK_EQUAL (isrCount [1], 2);
+
+  simulator.reset();
+  ioExpander.begin();
+}
+
+//============================================================================================//
+
+void testMaskedWrites() {
+  // Latches the library has not written. Only the masked bits may change.
+  simulator.poke (MCP23017_REG_OLATA, 0xA5U);
+  simulator.poke (MCP23017_REG_OLATB, 0x3CU);
+
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.writeMasked (0x0F00U, 0x0500U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 2);  // Read and write port B only
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0xA5U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x35U);
+
+  HOST_CHECK_EQUAL (ioExpander.setBits (0x4002U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0xA7U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x75U);
+
+  HOST_CHECK_EQUAL (ioExpander.clearBits (0x8080U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0x27U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x75U);
+
+  HOST_CHECK_EQUAL (ioExpander.toggleBits (0x0FF0U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0xD7U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x7AU);
+
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.writeMasked (0, 0xFFFFU), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 0);
+
+  // The trusted cache writes without reading, from a shadow synced with readAll().
+  HOST_CHECK_EQUAL (ioExpander.readAll(), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.setCachePolicy (MCP23017_CACHE_TRUSTED), MCP23017_RESP_OK);
+  counter.reset();
+  HOST_CHECK_EQUAL (ioExpander.clearBits (0x0001U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.writeMasked (0x8001U, 0x0001U), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (counter.counts().transactions, 2);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), 0xD7U);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), 0x7AU);
+  HOST_CHECK_EQUAL (ioExpander.setCachePolicy (MCP23017_CACHE_READTHROUGH), MCP23017_RESP_OK);
+
+  simulator.reset();
+  ioExpander.begin();
+}
+
+//============================================================================================//
+
+void testAttachInterrupt() {
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+
+  // Without a host interrupt, attaching must fail and leave the device as it is.
+  hostSilence (true);
+  ioExpander.pinMode (3, INPUT_PULLUP);
+  HOST_CHECK (ioExpander.attachInterrupt (3, isr, MCP23017_INT_FALLING) != MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENA), 0);
+
+  // Output pins can not have interrupts.
+  ioExpander.pinMode (7, OUTPUT);
+  HOST_CHECK_EQUAL (ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR), MCP23017_RESP_OK);
+  HOST_CHECK (ioExpander.attachInterrupt (7, isr, MCP23017_INT_CHANGE) != MCP23017_RESP_OK);
+  hostSilence (false);
+
+  // The model raises INTA on the host pin. Drive the inputs to their idle levels before
+  // attaching, so that no interrupt is pending when the test starts.
+  simulator.attachOutput (MCP23017_PORT_A, intaEdge);
+  hostSetPinSource (HOST_INT_PIN, intaLevel);
+  simulator.setInputs (0xFFFFU);
+  simulator.setInput (12, LOW);
+
+  uint8_t iocon = simulator.peek (MCP23017_REG_IOCON);
+  HOST_CHECK (iocon & (1U << MCP23017_BIT_ODR));
+  HOST_CHECK (iocon & (1U << MCP23017_BIT_MIRROR));
+  HOST_CHECK (hostInterruptHandler (HOST_INT_PIN) != NULL);
+
+  ioExpander.pinMode (5, INPUT_PULLUP);
+  ioExpander.pinMode (12, INPUT_PULLUP);
+  ioExpander.pinMode (14, INPUT_PULLUP);
+
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (3, isr, MCP23017_INT_FALLING), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (5, isr, MCP23017_INT_CHANGE), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (12, isr, MCP23017_INT_RISING), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (14, isr, MCP23017_INT_LOW), MCP23017_RESP_OK);
+
+  // FALLING and LOW compare with DEFVAL = 1, RISING with DEFVAL = 0, CHANGE does not compare.
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENA), 0x28);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_GPINTENB), 0x50);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_INTCONA), 0x08);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_INTCONB), 0x50);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_DEFVALA), 0x08);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_DEFVALB), 0x40);
+
+  // The shadow registers must agree with the device, including both IOCON addresses.
+  for (uint8_t i = MCP23017_REG_IODIRA; i <= MCP23017_REG_GPPUB; i++) {
+    HOST_CHECK_EQUAL (ioExpander.regBank [i], simulator.peek (i));
+  }
+}
+
+//============================================================================================//
+
+void testIsrSupervisor() {
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+
+  // A falling edge calls the ISR once, and releases the interrupt output.
+  simulator.setInput (3, LOW);
+  HOST_CHECK_EQUAL (intaLevel(), LOW);
+  HOST_CHECK (ioExpander.interruptPending());
+  counter.reset();
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (isrCount [3], 1);
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+  HOST_CHECK (!ioExpander.interruptPending());
+
+  // Holding the pin low does not call it again, and the release is not an event.
+  service();
+  simulator.setInput (3, HIGH);
+  service();
+  HOST_CHECK_EQUAL (isrCount [3], 1);
+
+  // Re-armed after the release.
+  simulator.setInput (3, LOW);
+  service();
+  HOST_CHECK_EQUAL (isrCount [3], 2);
+  simulator.setInput (3, HIGH);
+  service();
+
+  // CHANGE calls the ISR on both edges.
+  simulator.setInput (5, LOW);
+  service();
+  simulator.setInput (5, HIGH);
+  service();
+  HOST_CHECK_EQUAL (isrCount [5], 2);
+
+  // Edge pins have no holdoff by default, so edges 2 ms apart are all served.
+  for (uint8_t i = 0; i < 4; i++) {
+    simulator.setInput (5, (i & 0x1U) ? HIGH : LOW);
+    ioExpander.dispatchInterrupt();
+    hostAdvanceMicros (2000UL);
+  }
+
+  HOST_CHECK_EQUAL (isrCount [5], 6);
+
+  // An explicit holdoff debounces them. Only the first edge is served.
+  ioExpander.setInterruptTiming (5, 10, MCP23017_INT_REARM_MS);
+  service();
+
+  for (uint8_t i = 0; i < 4; i++) {
+    simulator.setInput (5, (i & 0x1U) ? HIGH : LOW);
+    ioExpander.dispatchInterrupt();
+    hostAdvanceMicros (2000UL);
+  }
+
+  HOST_CHECK_EQUAL (isrCount [5], 7);
+  ioExpander.setInterruptTiming (5, MCP23017_INT_HOLDOFF_AUTO, MCP23017_INT_REARM_MS);
+  service();
+
+  // Edges on both ports before the service are handled in one supervisor pass.
+  simulator.setInput (3, LOW);
+  simulator.setInput (12, HIGH);
+  counter.reset();
+  ioExpander.isrSupervisor();
+  HOST_CHECK_EQUAL (isrCount [3], 3);
+  HOST_CHECK_EQUAL (isrCount [12], 1);
+  // One burst for the flags and captures, one GPINTEN write per port to disarm, and one INTCAP
+  // read to release the output.
+  HOST_CHECK_EQUAL (counter.counts().transactions, 4);
+  HOST_CHECK_EQUAL (ioExpander.lastIntPin, 3);
+
+  // Direct supervisor calls leave the host flag to the dispatcher.
+  service();
+  simulator.setInput (3, HIGH);
+  simulator.setInput (12, LOW);
+  service();
+
+  // LOW keeps calling the ISR at the holdoff rate while the level persists.
+  simulator.setInput (14, LOW);
+
+  for (uint8_t i = 0; i < 5; i++) {
+    service();
+  }
+
+  HOST_CHECK (isrCount [14] >= 4);
+  // An event latched while the level was held is still served once after the release.
+  simulator.setInput (14, HIGH);
+  service();
+  int lowCount = isrCount [14];
+  service();
+  service();
+  HOST_CHECK_EQUAL (isrCount [14], lowCount);
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+}
+
+//============================================================================================//
+
+// An ISR that flips another input, like a handler that drives a line looped back to the IOE.
+void chainIsr (int8_t pin, void *context) {
+  isr (pin);
+  uint8_t target = uint8_t (uintptr_t (context));
+  uint16_t gpio = uint16_t (simulator.peek (MCP23017_REG_GPIOA)) | (uint16_t (simulator.peek (MCP23017_REG_GPIOB)) << 8);
+  simulator.setInput (target, ((gpio >> target) & 0x1U) ? LOW : HIGH);
+}
+
+void testHandlerEdges() {
+  // A compare mode pin is disarmed after service. The edge its ISR causes on a change pin of
+  // the same port must be served, not cleared by the read that releases the output.
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (3, chainIsr, MCP23017_INT_FALLING, (void *) uintptr_t (5)), MCP23017_RESP_OK);
+  int count3 = isrCount [3];
+  int count5 = isrCount [5];
+
+  simulator.setInput (3, LOW);
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (isrCount [3], count3 + 1);
+  HOST_CHECK_EQUAL (isrCount [5], count5 + 1);
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+
+  service();
+  simulator.setInput (3, HIGH);
+  simulator.setInput (5, HIGH);
+  service();
+  HOST_CHECK_EQUAL (isrCount [5], count5 + 2);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (3, isr, MCP23017_INT_FALLING), MCP23017_RESP_OK);
+
+  // A compare mode pin held active is due for a re-arm check while a change pin is served, and
+  // the ISR of that pin causes an edge on another change pin. The re-arm check must not clear it.
+  ioExpander.pinMode (6, INPUT_PULLUP);
+  ioExpander.pinMode (13, INPUT_PULLUP);
+  simulator.setInput (6, HIGH);
+  simulator.setInput (13, HIGH);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (6, isr, MCP23017_INT_CHANGE), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (13, isr, MCP23017_INT_FALLING), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.attachInterrupt (5, chainIsr, MCP23017_INT_CHANGE, (void *) uintptr_t (6)), MCP23017_RESP_OK);
+  service();
+
+  simulator.setInput (13, LOW);
+  service();  // Served, disarmed and held low past the re-arm interval
+  HOST_CHECK_EQUAL (isrCount [13], 1);
+
+  count5 = isrCount [5];
+  int count6 = isrCount [6];
+  hostAdvanceMicros (20000UL); // Pin 13 is due for a check in the next dispatch
+  simulator.setInput (5, LOW);
+  ioExpander.dispatchInterrupt();
+  HOST_CHECK_EQUAL (isrCount [5], count5 + 1);
+  HOST_CHECK_EQUAL (isrCount [6], count6 + 1);
+  HOST_CHECK_EQUAL (isrCount [13], 1);
+
+  simulator.setInput (13, HIGH);
+  service();
+  service();
+  HOST_CHECK_EQUAL (isrCount [6], count6 + 1);
+  HOST_CHECK_EQUAL (intaLevel(), HIGH);
+}
+
+//============================================================================================//
+
+int main() {
+  testReadAll();
+  testBeginAccessMode();
+  testBatch();
+  testPolling();
+  testMaskedWrites();
+  testAttachInterrupt();
+  testIsrSupervisor();
+  testHandlerEdges();
+  hostSetPinSource (HOST_INT_PIN, NULL);
+
+  return hostTestResult ("SimulatorTest");
+}
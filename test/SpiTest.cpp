@@ -0,0 +1,153 @@
+//============================================================================================//
+
+// Tests the MCP23S17 SPI transport against a mock device behind the stub SPIClass. The mock
+// decodes the control byte and the register address of each frame, and keeps the registers in
+// the behavioural model. Like the real device, it only answers hardware address 0 until HAEN is
+// set.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_SPI.h>
+#include <CSE_MCP23017_Sim.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SPI_ADDRESS         0x23  // A2..A0 = 3
+#define   CS_PIN              10
+
+CSE_MCP23017_Sim device (SPI_ADDRESS);
+CSE_MCP23017_SPI spiTransport (&SPI, CS_PIN);
+
+uint32_t frame = 0;
+uint32_t frameBytes = 0;
+bool frameSelected = false;
+bool frameRead = false;
+uint8_t frameRegister = 0;
+
+//============================================================================================//
+
+uint8_t mockTransfer (uint8_t data) {
+  if (SPI.transactionCount != frame) {  // A new frame
+    frame = SPI.transactionCount;
+    frameBytes = 0;
+  }
+
+  HOST_CHECK_EQUAL (digitalRead (CS_PIN), LOW);
+  uint32_t position = frameBytes++;
+
+  if (position == 0) {
+    bool haen = device.peek (MCP23017_REG_IOCON) & (1U << MCP23017_BIT_HAEN);
+    uint8_t hardwareAddress = haen ? (SPI_ADDRESS & 0x07U) : 0;
+    frameSelected = ((data & 0xFEU) == (MCP23S17_OPCODE | (hardwareAddress << 1)));
+    frameRead = data & MCP23S17_OPCODE_READ;
+    return 0xFF;
+  }
+
+  if (!frameSelected) {
+    return 0xFF;  // MISO stays high-Z, pulled up
+  }
+
+  if (position == 1) {
+    frameRegister = data;
+    return 0xFF;
+  }
+
+  // Sequential mode, the register advances after each byte.
+  uint8_t regAddress = uint8_t (frameRegister + (position - 2));
+  uint8_t value = 0;
+
+  if (frameRead) {
+    device.writeThenRead (SPI_ADDRESS, regAddress, &value, 1);
+    return value;
+  }
+
+  device.write (SPI_ADDRESS, regAddress, &data, 1);
+  return 0xFF;
+}
+
+//============================================================================================//
+
+void testNoDevice() {
+  SPI.transferHook = NULL;
+
+  uint32_t starts = SPI.beginCount;
+  HOST_CHECK_EQUAL (spiTransport.begin (SPI_ADDRESS), MCP23017_ERROR_RF);
+  HOST_CHECK_EQUAL (SPI.beginCount, starts + 1);
+  HOST_CHECK_EQUAL (SPI.transactionDepth, 0);
+  HOST_CHECK_EQUAL (spiTransport.probe (SPI_ADDRESS), MCP23017_ERROR_RF);
+
+  // A write can only be found failed by reading it back.
+  uint8_t value = 0x3C;
+  HOST_CHECK_EQUAL (spiTransport.write (SPI_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_RESP_OK);
+  spiTransport.setWriteVerify (true);
+  HOST_CHECK_EQUAL (spiTransport.write (SPI_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_ERROR_WF);
+  spiTransport.setWriteVerify (false);
+
+  // Invalid buffers and lengths are refused without a transaction.
+  uint32_t frames = SPI.transactionCount;
+  HOST_CHECK_EQUAL (spiTransport.write (SPI_ADDRESS, MCP23017_REG_OLATA, NULL, 1), MCP23017_ERROR_OOR);
+  HOST_CHECK_EQUAL (spiTransport.writeThenRead (SPI_ADDRESS, MCP23017_REG_OLATA, NULL, 1), MCP23017_ERROR_OOR);
+  HOST_CHECK_EQUAL (spiTransport.write (SPI_ADDRESS, MCP23017_REG_OLATA, &value, MCP23S17_MAX_LENGTH + 1UL), MCP23017_ERROR_OOR);
+  HOST_CHECK_EQUAL (spiTransport.readN (SPI_ADDRESS, NULL, 1), 0);
+  HOST_CHECK_EQUAL (SPI.transactionCount, frames);
+
+  CSE_MCP23017_SPI noController (NULL, CS_PIN);
+  HOST_CHECK_EQUAL (noController.begin (SPI_ADDRESS), MCP23017_ERROR_OF);
+  HOST_CHECK_EQUAL (noController.write (SPI_ADDRESS, MCP23017_REG_OLATA, &value, 1), MCP23017_ERROR_OF);
+}
+
+//============================================================================================//
+
+void testDevice() {
+  SPI.transferHook = mockTransfer;
+  device.reset();
+
+  CSE_MCP23017 ioExpander (0xFF, SPI_ADDRESS, &spiTransport);
+  CSE_MCP23017 absent (0xFF, 0x24, &spiTransport);
+
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+  HOST_CHECK (device.peek (MCP23017_REG_IOCON) & (1U << MCP23017_BIT_HAEN));
+  HOST_CHECK_EQUAL (SPI.transactionDepth, 0);
+  HOST_CHECK_EQUAL (digitalRead (CS_PIN), HIGH);
+
+  // Only the device at the matching hardware address answers once HAEN is set.
+  hostSilence (true);
+  HOST_CHECK (absent.begin() != MCP23017_RESP_OK);
+  hostSilence (false);
+
+  // The register API works unchanged, and every write keeps HAEN set.
+  HOST_CHECK_EQUAL (ioExpander.pinMode (8, OUTPUT), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (ioExpander.digitalWrite (8, HIGH), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (device.outputs(), 0x0100);
+  HOST_CHECK_EQUAL (ioExpander.writeWord (0xA500), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (device.peek (MCP23017_REG_OLATB), 0xA5);
+
+  device.setInput (3, LOW);
+  HOST_CHECK_EQUAL (ioExpander.digitalRead (3), LOW);
+  device.setInput (3, HIGH);
+  HOST_CHECK_EQUAL (ioExpander.digitalRead (3), HIGH);
+
+  HOST_CHECK_EQUAL (ioExpander.setAccessMode (MCP23017_BANK_GROUP, MCP23017_ADDR_SEQUENTIAL), MCP23017_RESP_OK);
+  HOST_CHECK (device.peek (MCP23017_REG_IOCON) & (1U << MCP23017_BIT_HAEN));
+  HOST_CHECK_EQUAL (ioExpander.readAll(), MCP23017_RESP_OK);
+
+  for (uint8_t i = 0; i < MCP23017_SIM_REGCOUNT; i++) {
+    HOST_CHECK_EQUAL (ioExpander.regBank [i], device.peek (i));
+  }
+
+  // Verified writes pass against a device that is there.
+  spiTransport.setWriteVerify (true);
+  HOST_CHECK_EQUAL (ioExpander.writeWord (0x1234), MCP23017_RESP_OK);
+  spiTransport.setWriteVerify (false);
+
+  HOST_CHECK_EQUAL (SPI.transactionDepth, 0);
+}
+
+//============================================================================================//
+
+int main() {
+  testNoDevice();
+  testDevice();
+
+  return hostTestResult ("SpiTest");
+}
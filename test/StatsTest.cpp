@@ -0,0 +1,120 @@
+//============================================================================================//
+
+// Tests the runtime statistics, built with MCP23017_ENABLE_STATS. Checks the transfer counters
+// and the log2 buckets of the interrupt latency histogram, which must not depend on the width
+// of long on the host.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include "HostTest.h"
+
+#ifndef MCP23017_ENABLE_STATS
+  #error "StatsTest must be built with MCP23017_ENABLE_STATS"
+#endif
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   HOST_INT_PIN        2
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &simulator);
+
+int isrCount = 0;
+
+//============================================================================================//
+
+void isr (int8_t pin) {
+  (void) pin;
+  isrCount++;
+}
+
+void intaEdge() {
+  void (*handler)(void) = hostInterruptHandler (HOST_INT_PIN);
+
+  if (handler != NULL) {
+    handler();
+  }
+}
+
+uint8_t intaLevel() {
+  return simulator.interruptOutput (MCP23017_PORT_A);
+}
+
+// Makes a falling edge on pin 3, and services it after the given latency. The release is not an
+// event, and the pin is re-armed after the holdoff.
+void interruptAfter (uint32_t latency) {
+  simulator.setInput (3, LOW);
+  hostAdvanceMicros (latency);
+  ioExpander.dispatchInterrupt();
+  simulator.setInput (3, HIGH);
+  hostAdvanceMicros (20000UL);  // Past the holdoff
+  ioExpander.dispatchInterrupt();
+}
+
+//============================================================================================//
+
+void testTransfers() {
+  CSE_MCP23017 absent (0xFF, 0x21, &simulator);
+
+  hostSilence (true);
+  absent.begin();
+  absent.digitalWrite (8, HIGH);
+  hostSilence (false);
+
+  ioeStats_t stats = absent.snapshotStats();
+  HOST_CHECK (stats.nacks >= 2);
+  HOST_CHECK_EQUAL (stats.nacks, stats.transactions);
+  HOST_CHECK_EQUAL (stats.bytes, 0);
+
+  ioExpander.begin();
+  ioExpander.resetStats();
+  ioExpander.writeWord (0xA500);
+  ioExpander.readWord();
+
+  stats = ioExpander.snapshotStats();
+  HOST_CHECK_EQUAL (stats.transactions, 2);
+  HOST_CHECK_EQUAL (stats.bytes, 4);
+  HOST_CHECK_EQUAL (stats.nacks, 0);
+  HOST_CHECK_EQUAL (stats.readUnderruns, 0);
+}
+
+//============================================================================================//
+
+void testLatency() {
+  simulator.attachOutput (MCP23017_PORT_A, intaEdge);
+  hostSetPinSource (HOST_INT_PIN, intaLevel);
+  simulator.setInputs (0xFFFFU);
+
+  ioExpander.configInterrupt (HOST_INT_PIN, MCP23017_OPENDRAIN, MCP23017_INT_MIRROR);
+  ioExpander.pinMode (3, INPUT_PULLUP);
+  ioExpander.attachInterrupt (3, isr, MCP23017_INT_FALLING);
+  ioExpander.resetStats();
+
+  interruptAfter (1);
+  interruptAfter (1000); // 2^9 <= 1000 < 2^10
+  interruptAfter (1023);
+  interruptAfter (4096);
+  interruptAfter (100000UL); // Beyond the last bucket
+
+  ioeStats_t stats = ioExpander.snapshotStats();
+
+  HOST_CHECK_EQUAL (stats.latency [0], 1);
+  HOST_CHECK_EQUAL (stats.latency [9], 2);
+  HOST_CHECK_EQUAL (stats.latency [12], 1);
+  HOST_CHECK_EQUAL (stats.latency [MCP23017_STATS_BUCKETS - 1], 1);
+  HOST_CHECK_EQUAL (isrCount, 5);
+  HOST_CHECK_EQUAL (stats.interruptsServiced, 5);
+  HOST_CHECK_EQUAL (stats.interruptsReceived, stats.interruptsServiced);
+
+  hostSetPinSource (HOST_INT_PIN, NULL);
+}
+
+//============================================================================================//
+
+int main() {
+  testTransfers();
+  testLatency();
+
+  return hostTestResult ("StatsTest");
+}
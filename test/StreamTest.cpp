@@ -0,0 +1,106 @@
+//============================================================================================//
+
+// Tests the chunking of multi-byte writes and output streams over a transport with a short,
+// odd transaction limit. Every 16-bit stream transaction must carry whole frames, and empty
+// writes must not reach the bus.
+
+#include <CSE_MCP23017.h>
+#include <CSE_MCP23017_Sim.h>
+#include "HostTest.h"
+
+//============================================================================================//
+
+#define   SIM_ADDRESS         0x20
+#define   SHORT_MAX_LENGTH    5U  // Two 16-bit frames and a spare byte
+#define   STREAM_FRAMES       11U
+
+//============================================================================================//
+/**
+ * @brief Forwards to the simulator with a short transaction limit, and records the writes.
+ *
+ */
+class ShortTransport final : public CSE_MCP23017_Transport {
+  public:
+    CSE_MCP23017_Sim *device;
+    size_t limit = SHORT_MAX_LENGTH;
+    uint32_t writes = 0;
+    uint32_t oddWrites = 0; // Writes that split a 16-bit frame
+    uint32_t wrongStart = 0;  // Stream writes that did not start at OLATA
+
+    ShortTransport (CSE_MCP23017_Sim *sim) : device (sim) {}
+
+    uint8_t probe (uint8_t address) override { return device->probe (address); }
+
+    uint8_t write (uint8_t address, uint8_t regAddress, const uint8_t *data, size_t length) override {
+      writes++;
+      oddWrites += ((length & 0x1U) != 0) ? 1 : 0;
+      wrongStart += (regAddress != MCP23017_REG_OLATA) ? 1 : 0;
+      return device->write (address, regAddress, data, length);
+    }
+
+    uint8_t writeThenRead (uint8_t address, uint8_t regAddress, uint8_t *data, size_t length) override {
+      return device->writeThenRead (address, regAddress, data, length);
+    }
+
+    size_t readN (uint8_t address, uint8_t *data, size_t length) override { return device->readN (address, data, length); }
+    size_t maxLength() override { return limit; }
+};
+
+//============================================================================================//
+
+CSE_MCP23017_Sim simulator (SIM_ADDRESS);
+ShortTransport shortBus (&simulator);
+CSE_MCP23017 ioExpander (0xFF, SIM_ADDRESS, &shortBus);
+
+//============================================================================================//
+
+void testEmptyWrite() {
+  uint8_t data [1] = {0};
+
+  shortBus.writes = 0;
+  HOST_CHECK_EQUAL (ioExpander.write (MCP23017_REG_OLATA, data, 0, 0), MCP23017_RESP_OK);
+  HOST_CHECK_EQUAL (shortBus.writes, 0);
+}
+
+//============================================================================================//
+
+void testStream16() {
+  uint16_t frames [STREAM_FRAMES];
+
+  for (uint8_t i = 0; i < STREAM_FRAMES; i++) {
+    frames [i] = uint16_t (0x0101U * (i + 1));
+  }
+
+  ioExpander.setAccessMode (MCP23017_BANK_PAIR, MCP23017_ADDR_BYTE);
+  shortBus.writes = 0;
+  shortBus.oddWrites = 0;
+  shortBus.wrongStart = 0;
+
+  HOST_CHECK_EQUAL (ioExpander.streamOutput (frames, STREAM_FRAMES), MCP23017_RESP_OK);
+
+  // Two frames per transaction.
+  HOST_CHECK_EQUAL (shortBus.writes, (STREAM_FRAMES + 1) / 2);
+  HOST_CHECK_EQUAL (shortBus.oddWrites, 0);
+  HOST_CHECK_EQUAL (shortBus.wrongStart, 0);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATA), frames [STREAM_FRAMES - 1] & 0xFFU);
+  HOST_CHECK_EQUAL (simulator.peek (MCP23017_REG_OLATB), frames [STREAM_FRAMES - 1] >> 8);
+
+  // A transport that can not carry a whole frame is refused.
+  shortBus.limit = 1;
+  shortBus.writes = 0;
+  HOST_CHECK_EQUAL (ioExpander.streamOutput (frames, STREAM_FRAMES), MCP23017_ERROR_OOR);
+  HOST_CHECK_EQUAL (shortBus.writes, 0);
+  shortBus.limit = SHORT_MAX_LENGTH;
+
+  ioExpander.setAccessMode (MCP23017_BANK_PAIR, MCP23017_ADDR_SEQUENTIAL);
+}
+
+//============================================================================================//
+
+int main() {
+  HOST_CHECK_EQUAL (ioExpander.begin(), MCP23017_RESP_OK);
+  testEmptyWrite();
+  testStream16();
+
+  return hostTestResult ("StreamTest");
+}
@@ -0,0 +1,149 @@
+//============================================================================================//
+// Includes
+
+#include "Arduino.h"
+#include "Wire.h"
+#include "SPI.h"
+
+//============================================================================================//
+
+HardwareSerial Serial;
+TwoWire Wire;
+SPIClass SPI;
+
+static unsigned long hostMicros = 0;
+static uint8_t pinLevel [HOST_PIN_COUNT];
+static uint8_t (*pinSource [HOST_PIN_COUNT])(void);
+static void (*interruptHandler [HOST_PIN_COUNT])(void);
+static bool serialSilent = false;
+
+//============================================================================================//
+
+static std::string toBase (unsigned long long value, int base) {
+  if ((base < 2) || (base > 16)) {
+    base = DEC;
+  }
+
+  std::string digits;
+
+  do {
+    digits.insert (digits.begin(), "0123456789ABCDEF" [value % base]);
+    value /= base;
+  } while (value > 0);
+
+  return digits;
+}
+
+String:: String (int value, unsigned char base) : String ((long) value, base) {}
+String:: String (unsigned int value, unsigned char base) : String ((unsigned long) value, base) {}
+String:: String (long value, unsigned char base) : text ((value < 0) && (base == DEC) ? "-" + toBase (0ULL - (unsigned long long) value, DEC) : toBase ((unsigned long) value, base)) {}
+String:: String (unsigned long value, unsigned char base) : text (toBase (value, base)) {}
+
+//============================================================================================//
+
+size_t Print:: write (uint8_t data) {
+  if (!serialSilent) {
+    putchar (data);
+  }
+
+  return 1;
+}
+
+size_t Print:: write (const char *text) {
+  size_t n = 0;
+
+  while (*text != '\0') {
+    n += write (uint8_t (*text++));
+  }
+
+  return n;
+}
+
+size_t Print:: print (const __FlashStringHelper *text) { return write (reinterpret_cast <const char*> (text)); }
+size_t Print:: print (const char *text) { return write (text); }
+size_t Print:: print (const String &text) { return write (text.c_str()); }
+size_t Print:: print (char value) { return write (uint8_t (value)); }
+size_t Print:: print (unsigned char value, int base) { return print ((unsigned long long) value, base); }
+size_t Print:: print (int value, int base) { return print ((long long) value, base); }
+size_t Print:: print (unsigned int value, int base) { return print ((unsigned long long) value, base); }
+size_t Print:: print (long value, int base) { return print ((long long) value, base); }
+size_t Print:: print (unsigned long value, int base) { return print ((unsigned long long) value, base); }
+
+size_t Print:: print (long long value, int base) {
+  if ((value < 0) && (base == DEC)) {
+    return write ("-") + write (toBase (0ULL - (unsigned long long) value, DEC).c_str());
+  }
+
+  return write (toBase ((unsigned long long) value, base).c_str());
+}
+
+size_t Print:: print (unsigned long long value, int base) {
+  return write (toBase (value, base).c_str());
+}
+
+size_t Print:: print (double value, int digits) {
+  char buffer [64];
+  snprintf (buffer, sizeof (buffer), "%.*f", digits, value);
+  return write (buffer);
+}
+
+size_t Print:: println() {
+  return write ("\r\n");
+}
+
+//============================================================================================//
+
+unsigned long millis() { return hostMicros / 1000UL; }
+unsigned long micros() { return hostMicros; }
+void delay (unsigned long ms) { hostMicros += ms * 1000UL; }
+void delayMicroseconds (unsigned int us) { hostMicros += us; }
+
+void pinMode (uint8_t pin, uint8_t mode) {
+  if ((pin < HOST_PIN_COUNT) && (mode == INPUT_PULLUP)) {
+    pinLevel [pin] = HIGH;
+  }
+}
+
+void digitalWrite (uint8_t pin, uint8_t value) {
+  if (pin < HOST_PIN_COUNT) {
+    pinLevel [pin] = value ? HIGH : LOW;
+  }
+}
+
+int digitalRead (uint8_t pin) {
+  if (pin >= HOST_PIN_COUNT) {
+    return LOW;
+  }
+
+  return (pinSource [pin] != NULL) ? pinSource [pin]() : pinLevel [pin];
+}
+
+int digitalPinToInterrupt (uint8_t pin) {
+  return (pin < HOST_PIN_COUNT) ? pin : NOT_AN_INTERRUPT;
+}
+
+void attachInterrupt (uint8_t interrupt, void (*handler)(void), int mode) {
+  (void) mode;
+
+  if (interrupt < HOST_PIN_COUNT) {
+    interruptHandler [interrupt] = handler;
+  }
+}
+
+void detachInterrupt (uint8_t interrupt) {
+  if (interrupt < HOST_PIN_COUNT) {
+    interruptHandler [interrupt] = NULL;
+  }
+}
+
+void noInterrupts() {}
+void interrupts() {}
+
+//============================================================================================//
+
+void hostAdvanceMicros (unsigned long us) { hostMicros += us; }
+void hostSetPin (uint8_t pin, uint8_t value) { digitalWrite (pin, value); }
+void hostSetPinSource (uint8_t pin, uint8_t (*source)(void)) { if (pin < HOST_PIN_COUNT) pinSource [pin] = source; }
+uint8_t hostPinOutput (uint8_t pin) { return uint8_t (digitalRead (pin)); }
+void (*hostInterruptHandler (uint8_t interrupt))(void) { return (interrupt < HOST_PIN_COUNT) ? interruptHandler [interrupt] : NULL; }
+void hostSilence (bool silent) { serialSilent = silent; }
@@ -0,0 +1,134 @@
+//============================================================================================//
+
+// A minimal Arduino core for building and testing the library on a desktop host. Only the
+// parts used by the library and its examples are provided. Time does not pass on its own, it
+// is advanced by the tests with `hostAdvanceMicros()`.
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+//============================================================================================//
+
+#define   HIGH                0x1
+#define   LOW                 0x0
+
+#define   INPUT               0x0
+#define   OUTPUT              0x1
+#define   INPUT_PULLUP        0x2
+
+#define   CHANGE              1
+#define   FALLING             2
+#define   RISING              3
+
+#define   DEC                 10
+#define   HEX                 16
+#define   OCT                 8
+#define   BIN                 2
+
+#define   NOT_AN_INTERRUPT    -1
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+//============================================================================================//
+
+class __FlashStringHelper;
+#define   F(string_literal)   (reinterpret_cast <const __FlashStringHelper*> (string_literal))
+
+//============================================================================================//
+
+class String {
+  private:
+    std::string text;
+
+  public:
+    String() {}
+    String (const char *value) : text (value) {}
+    String (const std::string &value) : text (value) {}
+    String (char value) : text (1, value) {}
+    String (int value, unsigned char base = DEC);
+    String (unsigned int value, unsigned char base = DEC);
+    String (long value, unsigned char base = DEC);
+    String (unsigned long value, unsigned char base = DEC);
+
+    const char* c_str() const { return text.c_str(); }
+    unsigned int length() const { return (unsigned int) text.length(); }
+    String& operator += (const String &other) { text += other.text; return *this; }
+    String& operator += (const char *other) { text += other; return *this; }
+    String& operator += (char other) { text += other; return *this; }
+    String operator + (const String &other) const { return String (text + other.text); }
+    bool operator == (const String &other) const { return text == other.text; }
+};
+
+//============================================================================================//
+
+class Print {
+  public:
+    virtual ~Print() {}
+    virtual size_t write (uint8_t data);
+    size_t write (const char *text);
+
+    size_t print (const __FlashStringHelper *text);
+    size_t print (const char *text);
+    size_t print (const String &text);
+    size_t print (char value);
+    size_t print (unsigned char value, int base = DEC);
+    size_t print (int value, int base = DEC);
+    size_t print (unsigned int value, int base = DEC);
+    size_t print (long value, int base = DEC);
+    size_t print (unsigned long value, int base = DEC);
+    size_t print (long long value, int base = DEC);
+    size_t print (unsigned long long value, int base = DEC);
+    size_t print (double value, int digits = 2);
+
+    size_t println();
+    template <typename T> size_t println (T value) { size_t n = print (value); return n + println(); }
+    template <typename T> size_t println (T value, int format) { size_t n = print (value, format); return n + println(); }
+};
+
+class HardwareSerial : public Print {
+  public:
+    void begin (unsigned long baud) { (void) baud; }
+    void end() {}
+    void flush() { fflush (stdout); }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+//============================================================================================//
+
+unsigned long millis();
+unsigned long micros();
+void delay (unsigned long ms);
+void delayMicroseconds (unsigned int us);
+
+void pinMode (uint8_t pin, uint8_t mode);
+void digitalWrite (uint8_t pin, uint8_t value);
+int digitalRead (uint8_t pin);
+
+int digitalPinToInterrupt (uint8_t pin);
+void attachInterrupt (uint8_t interrupt, void (*handler)(void), int mode);
+void detachInterrupt (uint8_t interrupt);
+void noInterrupts();
+void interrupts();
+
+//============================================================================================//
+// Host controls, not part of the Arduino API
+
+#define   HOST_PIN_COUNT      64
+
+void hostAdvanceMicros (unsigned long us);  // Moves the clock forward
+void hostSetPin (uint8_t pin, uint8_t value); // Drives an input pin of the host
+void hostSetPinSource (uint8_t pin, uint8_t (*source)(void)); // Reads a pin from a model, such as an interrupt output
+uint8_t hostPinOutput (uint8_t pin);  // Returns the level written to a pin
+void (*hostInterruptHandler (uint8_t interrupt))(void);  // Returns the handler attached to a pin
+void hostSilence (bool silent); // Suppresses the output of Serial
+
+#endif
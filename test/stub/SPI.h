@@ -0,0 +1,42 @@
+//============================================================================================//
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+#include "Arduino.h"
+
+//============================================================================================//
+
+#define   MSBFIRST            1
+#define   LSBFIRST            0
+#define   SPI_MODE0           0x00
+
+class SPISettings {
+  public:
+    SPISettings() {}
+    SPISettings (uint32_t clock, uint8_t bitOrder, uint8_t dataMode) { (void) clock; (void) bitOrder; (void) dataMode; }
+};
+
+//============================================================================================//
+/**
+ * @brief An SPI controller that forwards every byte to `transferHook`, if set. The tests put a
+ * device model behind it. With no hook, MISO reads as 0xFF, like a floating line with a pull-up.
+ *
+ */
+class SPIClass {
+  public:
+    uint8_t (*transferHook)(uint8_t data) = NULL; // Device model, called for each byte
+    uint32_t beginCount = 0;  // Calls to begin()
+    int32_t transactionDepth = 0; // beginTransaction() minus endTransaction()
+    uint32_t transactionCount = 0;  // Calls to beginTransaction(), a new count starts a new frame
+
+    void begin() { beginCount++; }
+    void end() {}
+    void beginTransaction (SPISettings settings) { (void) settings; transactionDepth++; transactionCount++; }
+    void endTransaction() { transactionDepth--; }
+    uint8_t transfer (uint8_t data) { return (transferHook != NULL) ? transferHook (data) : 0xFF; }
+};
+
+extern SPIClass SPI;
+
+#endif
@@ -0,0 +1,30 @@
+//============================================================================================//
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include "Arduino.h"
+
+//============================================================================================//
+/**
+ * @brief An I2C controller with no devices on the bus. Every address is not acknowledged. Use
+ * the transports of the library, such as `CSE_MCP23017_Sim`, to talk to a device on the host.
+ *
+ */
+class TwoWire {
+  public:
+    void begin() {}
+    void end() {}
+    void setClock (uint32_t clock) { (void) clock; }
+    void beginTransmission (uint8_t address) { (void) address; }
+    uint8_t endTransmission (bool sendStop = true) { (void) sendStop; return 2; } // Address NACK
+    size_t write (uint8_t data) { (void) data; return 1; }
+    size_t write (const uint8_t *data, size_t length) { (void) data; return length; }
+    uint8_t requestFrom (uint8_t address, uint8_t quantity, uint8_t sendStop = 1) { (void) address; (void) quantity; (void) sendStop; return 0; }
+    int available() { return 0; }
+    int read() { return -1; }
+};
+
+extern TwoWire Wire;
+
+#endif